@@ -0,0 +1,98 @@
+/**
+ * @file benchmark_dgm_solo12.cpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Benchmarks of the DGMSolo12 hot paths, only built with the
+ * dynamic_graph_manager.
+ */
+
+#include <array>
+
+#include "benchmark_harness.hpp"
+#include "solo/dynamic_graph_manager/dgm_solo12.hpp"
+
+namespace solo
+{
+namespace benchmarks
+{
+void run_dgm_benchmarks(BenchmarkRunner& runner)
+{
+    if (!runner.is_selected("dgm_solo12_"))
+    {
+        return;
+    }
+    DGMSolo12 dgm;
+    dgm.initialize_drivers("fake", "");
+
+    // Same entries as the sensors of the dgm_parameters_solo12.yaml.
+    dynamic_graph_manager::VectorDGMap map;
+    map["joint_positions"].resize(12);
+    map["joint_velocities"].resize(12);
+    map["joint_torques"].resize(12);
+    map["joint_target_torques"].resize(12);
+    map["joint_encoder_index"].resize(12);
+    map["slider_positions"].resize(4);
+    map["imu_accelerometer"].resize(3);
+    map["imu_gyroscope"].resize(3);
+    map["imu_attitude"].resize(3);
+    map["imu_linear_acceleration"].resize(3);
+    map["imu_attitude_quaternion"].resize(4);
+    map["motor_enabled"].resize(12);
+    map["motor_ready"].resize(12);
+    map["motor_board_enabled"].resize(6);
+    map["motor_board_errors"].resize(6);
+
+    runner.run("dgm_solo12_get_sensors_to_map", [&dgm, &map]() {
+        dgm.get_sensors_to_map(map);
+        do_not_optimize(map);
+    });
+
+    dynamic_graph_manager::VectorDGMap control_map;
+    control_map["ctrl_joint_torques"] = Eigen::VectorXd::Zero(12);
+    runner.run("dgm_solo12_set_motor_controls_from_map",
+               [&dgm, &control_map]() {
+                   dgm.set_motor_controls_from_map(control_map);
+                   do_not_optimize(control_map);
+               });
+
+    // Cost of the entry lookups alone, by name as before the DGMapHandles
+    // and through the resolved handles.
+    static const std::array<const char*, 15> names = {
+        {"joint_positions",
+         "joint_velocities",
+         "joint_torques",
+         "joint_target_torques",
+         "joint_encoder_index",
+         "slider_positions",
+         "imu_accelerometer",
+         "imu_gyroscope",
+         "imu_attitude",
+         "imu_linear_acceleration",
+         "imu_attitude_quaternion",
+         "motor_enabled",
+         "motor_ready",
+         "motor_board_enabled",
+         "motor_board_errors"}};
+    runner.run("dgm_solo12_map_lookups_by_name", [&map]() {
+        for (const char* name : names)
+        {
+            map.at(name)[0] = 1.0;
+        }
+        do_not_optimize(map);
+    });
+    DGMapHandles<15> handles(names);
+    runner.run("dgm_solo12_map_lookups_by_handle", [&map, &handles]() {
+        handles.resolve(map);
+        for (int i = 0; i < 15; ++i)
+        {
+            handles[i][0] = 1.0;
+        }
+        do_not_optimize(map);
+    });
+}
+
+}  // namespace benchmarks
+}  // namespace solo
@@ -0,0 +1,183 @@
+/**
+ * @file benchmark_harness.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Minimal timing and allocation counting harness for the
+ * solo_benchmarks target.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace solo
+{
+namespace benchmarks
+{
+/**
+ * @brief Number and size of the heap allocations of the process. Incremented
+ * by the replaced global operator new of solo_benchmarks.cpp.
+ */
+struct AllocationCounter
+{
+    /** @brief Number of calls to operator new. */
+    static std::atomic<uint64_t> count;
+    /** @brief Total number of bytes requested to operator new. */
+    static std::atomic<uint64_t> bytes;
+};
+
+/**
+ * @brief Prevent the compiler from optimizing away a computed value.
+ */
+template <class T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Result of one benchmark.
+ */
+struct BenchmarkResult
+{
+    /** @brief Name of the benchmark. */
+    std::string name;
+    /** @brief Number of timed iterations. */
+    uint64_t iterations;
+    /** @brief Mean duration of one iteration (ns). */
+    double ns_per_op;
+    /** @brief Mean number of heap allocations per iteration. */
+    double allocations_per_op;
+    /** @brief Mean number of heap allocated bytes per iteration. */
+    double bytes_per_op;
+};
+
+/**
+ * @brief Run benchmarks and collect their results.
+ */
+class BenchmarkRunner
+{
+public:
+    /**
+     * @brief Construct a new BenchmarkRunner.
+     *
+     * @param iterations Number of timed iterations of each benchmark.
+     * @param filter Only run the benchmarks whose name contains it.
+     */
+    BenchmarkRunner(uint64_t iterations, const std::string& filter)
+        : iterations_(iterations), filter_(filter)
+    {
+    }
+
+    /**
+     * @brief If a benchmark is selected by the filter.
+     *
+     * @param name
+     */
+    bool is_selected(const std::string& name) const
+    {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    /**
+     * @brief Time one operation.
+     *
+     * The operation is first run iterations / 10 times to warm up the
+     * caches, then timed over the requested iterations.
+     *
+     * @param name Name of the benchmark.
+     * @param operation The operation to measure, a callable without
+     * arguments. Passed by template to avoid the cost of std::function.
+     */
+    template <class Operation>
+    void run(const std::string& name, Operation operation)
+    {
+        if (!is_selected(name))
+        {
+            return;
+        }
+        for (uint64_t i = 0; i < iterations_ / 10; ++i)
+        {
+            operation();
+        }
+
+        const uint64_t allocation_count = AllocationCounter::count.load();
+        const uint64_t allocation_bytes = AllocationCounter::bytes.load();
+        const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations_; ++i)
+        {
+            operation();
+        }
+        const std::chrono::steady_clock::time_point stop =
+            std::chrono::steady_clock::now();
+        const uint64_t allocation_count_delta =
+            AllocationCounter::count.load() - allocation_count;
+        const uint64_t allocation_bytes_delta =
+            AllocationCounter::bytes.load() - allocation_bytes;
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations_;
+        result.ns_per_op =
+            std::chrono::duration<double, std::nano>(stop - start).count() /
+            iterations_;
+        result.allocations_per_op = double(allocation_count_delta) / iterations_;
+        result.bytes_per_op = double(allocation_bytes_delta) / iterations_;
+        results_.push_back(result);
+    }
+
+    /**
+     * @brief Get the results of the benchmarks run so far.
+     */
+    const std::vector<BenchmarkResult>& get_results() const
+    {
+        return results_;
+    }
+
+    /**
+     * @brief Write the results as a JSON document.
+     *
+     * @param stream
+     */
+    void write_json(std::ostream& stream) const
+    {
+        stream << "{\n  \"iterations\": " << iterations_
+               << ",\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i)
+        {
+            const BenchmarkResult& result = results_[i];
+            stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": \""
+                   << result.name << "\", \"iterations\": " << result.iterations
+                   << ", \"ns_per_op\": " << result.ns_per_op
+                   << ", \"allocations_per_op\": " << result.allocations_per_op
+                   << ", \"bytes_per_op\": " << result.bytes_per_op << "}";
+        }
+        stream << "\n  ]\n}\n";
+    }
+
+private:
+    /** @brief Number of timed iterations of each benchmark. */
+    uint64_t iterations_;
+    /** @brief Substring selecting the benchmarks to run. */
+    std::string filter_;
+    /** @brief Results of the benchmarks run so far. */
+    std::vector<BenchmarkResult> results_;
+};
+
+/**
+ * @brief Register the DGMSolo12 benchmarks, only built with the
+ * dynamic_graph_manager.
+ */
+void run_dgm_benchmarks(BenchmarkRunner& runner);
+
+}  // namespace benchmarks
+}  // namespace solo
@@ -0,0 +1,532 @@
+/**
+ * @file solo_benchmarks.cpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Microbenchmarks of the hot paths of the hardware wrappers.
+ *
+ * Everything runs without hardware: Solo12 uses the fake master board
+ * backend, SpiJointModules uses a master board interface that is never
+ * initialized and MasterBoardIoThreads exchanges with simulated boards.
+ * Usage:
+ *
+ *     solo_benchmarks [--iterations N] [--filter substring] [--json file]
+ *
+ * The results are printed as a table and written as JSON (to stdout if no
+ * file is given) to track the performance across releases.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include "benchmark_harness.hpp"
+#include "solo/filters.hpp"
+#include "solo/master_board_io_threads.hpp"
+#include "solo/rt_logger.hpp"
+#include "solo/slider.hpp"
+#include "solo/solo12.hpp"
+#include "solo/spi_joint_module.hpp"
+
+/*
+ * Count every heap allocation of the process.
+ */
+
+std::atomic<uint64_t> solo::benchmarks::AllocationCounter::count(0);
+std::atomic<uint64_t> solo::benchmarks::AllocationCounter::bytes(0);
+
+void* operator new(std::size_t size)
+{
+    solo::benchmarks::AllocationCounter::count.fetch_add(
+        1, std::memory_order_relaxed);
+    solo::benchmarks::AllocationCounter::bytes.fetch_add(
+        size, std::memory_order_relaxed);
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace solo
+{
+namespace benchmarks
+{
+/**
+ * @brief Analog sensor always returning the same measurement.
+ */
+class ConstantAnalogSensor : public blmc_drivers::AnalogSensorInterface
+{
+public:
+    ConstantAnalogSensor(double value)
+    {
+        measurement_ = std::make_shared<blmc_drivers::ScalarTimeseries>(10);
+        measurement_->append(value);
+    }
+
+    blmc_drivers::Ptr<const blmc_drivers::ScalarTimeseries> get_measurement()
+        const
+    {
+        return measurement_;
+    }
+
+private:
+    std::shared_ptr<blmc_drivers::ScalarTimeseries> measurement_;
+};
+
+/**
+ * @brief Solo12 control cycle on the fake master board.
+ */
+void run_solo12_benchmarks(BenchmarkRunner& runner)
+{
+    if (!runner.is_selected("solo12_"))
+    {
+        return;
+    }
+    Solo12 robot;
+    robot.initialize("fake", "");
+    Vector12d torques;
+    torques.setZero();
+    while (!robot.is_ready())
+    {
+        robot.acquire_sensors();
+        robot.send_target_joint_torque(torques);
+    }
+
+    runner.run("solo12_acquire_sensors", [&robot]() {
+        robot.acquire_sensors();
+        do_not_optimize(robot.get_joint_positions()(0));
+    });
+    runner.run("solo12_send_target_joint_torque",
+               [&robot, &torques]() { robot.send_target_joint_torque(torques); });
+    runner.run("solo12_control_cycle", [&robot, &torques]() {
+        robot.acquire_sensors();
+        torques = -0.1 * robot.get_joint_velocities();
+        robot.send_target_joint_torque(torques);
+    });
+}
+
+/**
+ * @brief Joint space conversions as SpiJointModules did them before the
+ * fused factors, as a baseline.
+ */
+template <int COUNT>
+class LegacyJointConversions
+{
+public:
+    typedef Eigen::Matrix<double, COUNT, 1> Vector;
+
+    LegacyJointConversions(const std::array<Motor*, COUNT>& motors,
+                           const Vector& polarities,
+                           const Vector& motor_constants,
+                           const Vector& gear_ratios,
+                           const Vector& max_currents)
+        : motors_(motors),
+          polarities_(polarities),
+          motor_constants_(motor_constants),
+          gear_ratios_(gear_ratios),
+          max_currents_(max_currents)
+    {
+        zero_angles_.setZero();
+    }
+
+    void set_torques(const Vector& desired_torques)
+    {
+        Vector desired_current = polarities_.cwiseProduct(desired_torques)
+                                     .cwiseQuotient(gear_ratios_)
+                                     .cwiseQuotient(motor_constants_);
+        desired_current = desired_current.cwiseMin(max_currents_);
+        desired_current = desired_current.cwiseMax(-max_currents_);
+        for (std::size_t i = 0; i < motors_.size(); i++)
+        {
+            motors_[i]->SetCurrentReference(desired_current(i));
+        }
+    }
+
+    Vector get_measured_torques() const
+    {
+        Vector torques;
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            torques(i) = motors_[i]->GetCurrent();
+        }
+        torques = torques.cwiseProduct(polarities_)
+                      .cwiseProduct(gear_ratios_)
+                      .cwiseProduct(motor_constants_);
+        return torques;
+    }
+
+    Vector get_measured_angles() const
+    {
+        Vector positions;
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            positions(i) = motors_[i]->GetPosition();
+        }
+        positions =
+            positions.cwiseProduct(polarities_).cwiseQuotient(gear_ratios_) -
+            zero_angles_;
+        return positions;
+    }
+
+    Vector get_measured_velocities() const
+    {
+        Vector velocities;
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            velocities(i) = motors_[i]->GetVelocity();
+        }
+        velocities =
+            velocities.cwiseProduct(polarities_).cwiseQuotient(gear_ratios_);
+        return velocities;
+    }
+
+private:
+    std::array<Motor*, COUNT> motors_;
+    Vector polarities_;
+    Vector motor_constants_;
+    Vector gear_ratios_;
+    Vector max_currents_;
+    Vector zero_angles_;
+};
+
+/**
+ * @brief Joint space conversions of SpiJointModules, compared to the legacy
+ * conversions.
+ *
+ * A master board drives at most 2 * N_SLAVES motors, larger COUNT values
+ * span several master boards.
+ */
+template <int COUNT>
+void run_spi_joint_modules_benchmarks(BenchmarkRunner& runner)
+{
+    constexpr int BOARD_COUNT = (COUNT + 2 * N_SLAVES - 1) / (2 * N_SLAVES);
+    typedef SpiJointModules<COUNT, BOARD_COUNT> JointModules;
+    typedef typename JointModules::Vector Vector;
+    const std::string prefix =
+        "spi_joint_modules_" + std::to_string(COUNT) + "_";
+    if (!runner.is_selected(prefix))
+    {
+        return;
+    }
+
+    // The interfaces are never initialized, no packet is sent.
+    typename JointModules::Boards master_boards;
+    for (int i = 0; i < BOARD_COUNT; ++i)
+    {
+        master_boards[i] = std::make_shared<MasterBoardInterface>("benchmark");
+    }
+    std::array<int, COUNT> motor_to_board_index;
+    std::array<int, COUNT> motor_to_card_index;
+    std::array<int, COUNT> motor_to_card_port_index;
+    std::array<bool, COUNT> reverse_polarities;
+    std::array<Motor*, COUNT> motors;
+    Vector polarities;
+    for (int i = 0; i < COUNT; ++i)
+    {
+        motor_to_board_index[i] = i / (2 * N_SLAVES);
+        motor_to_card_index[i] = (i / 2) % N_SLAVES;
+        motor_to_card_port_index[i] = i % 2;
+        reverse_polarities[i] = (i % 3) != 0;
+        polarities(i) = reverse_polarities[i] ? -1. : 1.;
+        MotorDriver& driver = master_boards[motor_to_board_index[i]]
+                                  ->motor_drivers[motor_to_card_index[i]];
+        motors[i] = i % 2 == 0 ? driver.motor1 : driver.motor2;
+    }
+    Vector ones = Vector::Ones();
+    JointModules joint_modules(master_boards,
+                               motor_to_board_index,
+                               motor_to_card_index,
+                               motor_to_card_port_index,
+                               0.025 * ones,
+                               9.0 * ones,
+                               Vector::Zero(),
+                               8.0 * ones,
+                               reverse_polarities);
+    LegacyJointConversions<COUNT> legacy(
+        motors, polarities, 0.025 * ones, 9.0 * ones, 8.0 * ones);
+
+    Vector torques = 0.5 * ones;
+    runner.run(prefix + "set_torques", [&joint_modules, &torques]() {
+        joint_modules.set_torques(torques);
+        do_not_optimize(torques);
+    });
+    runner.run(prefix + "legacy_set_torques", [&legacy, &torques]() {
+        legacy.set_torques(torques);
+        do_not_optimize(torques);
+    });
+    Vector positions, velocities, measured_torques;
+    runner.run(prefix + "get_measurements",
+               [&joint_modules, &positions, &velocities, &measured_torques]() {
+                   joint_modules.get_measurements(
+                       positions, velocities, measured_torques);
+                   do_not_optimize(positions);
+                   do_not_optimize(velocities);
+                   do_not_optimize(measured_torques);
+               });
+    runner.run(prefix + "legacy_get_measurements",
+               [&legacy, &positions, &velocities, &measured_torques]() {
+                   positions = legacy.get_measured_angles();
+                   velocities = legacy.get_measured_velocities();
+                   measured_torques = legacy.get_measured_torques();
+                   do_not_optimize(positions);
+                   do_not_optimize(velocities);
+                   do_not_optimize(measured_torques);
+               });
+}
+
+/**
+ * @brief Master board whose SendCommand() and ParseSensorData() busy wait
+ * for a fixed exchange duration, standing for the network transfer.
+ */
+class SimulatedMasterBoard
+{
+public:
+    SimulatedMasterBoard(double exchange_duration)
+    {
+        exchange_duration_ =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(exchange_duration));
+    }
+
+    void SendCommand()
+    {
+        exchange();
+    }
+
+    void ParseSensorData()
+    {
+        exchange();
+    }
+
+private:
+    void exchange()
+    {
+        const std::chrono::steady_clock::time_point end =
+            std::chrono::steady_clock::now() + exchange_duration_;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    std::chrono::steady_clock::duration exchange_duration_;
+};
+
+/**
+ * @brief One send and one parse on BOARD_COUNT simulated master boards,
+ * concurrently through MasterBoardIoThreads and one board after the other.
+ * Each exchange takes 10 us.
+ */
+template <int BOARD_COUNT>
+void run_master_board_io_threads_benchmarks(BenchmarkRunner& runner)
+{
+    typedef MasterBoardIoThreads<BOARD_COUNT, SimulatedMasterBoard> IoThreads;
+    const std::string prefix =
+        "master_board_io_threads_" + std::to_string(BOARD_COUNT) + "_";
+    if (!runner.is_selected(prefix))
+    {
+        return;
+    }
+
+    typename IoThreads::Boards boards;
+    for (int i = 0; i < BOARD_COUNT; ++i)
+    {
+        boards[i] = std::make_shared<SimulatedMasterBoard>(10e-6);
+    }
+    runner.run(prefix + "sequential", [&boards]() {
+        for (int i = 0; i < BOARD_COUNT; ++i)
+        {
+            boards[i]->SendCommand();
+        }
+        for (int i = 0; i < BOARD_COUNT; ++i)
+        {
+            boards[i]->ParseSensorData();
+        }
+    });
+    IoThreads io_threads(boards);
+    runner.run(prefix + "concurrent", [&io_threads]() {
+        io_threads.send_command();
+        io_threads.parse_sensor_data();
+    });
+}
+
+/**
+ * @brief Conversion of the analog measurements of Sliders.
+ */
+void run_sliders_benchmarks(BenchmarkRunner& runner)
+{
+    Sliders<4>::AnalogSensors analog_sensors;
+    for (std::size_t i = 0; i < analog_sensors.size(); ++i)
+    {
+        analog_sensors[i] = std::make_shared<ConstantAnalogSensor>(0.25 * i);
+    }
+    Sliders<4> sliders(analog_sensors,
+                       Sliders<4>::Vector::Zero(),
+                       Sliders<4>::Vector::Ones());
+
+    runner.run("sliders_4_get_positions",
+               [&sliders]() { do_not_optimize(sliders.get_positions()); });
+}
+
+/**
+ * @brief Filters of the sliders and of the joint signals.
+ */
+void run_filters_benchmarks(BenchmarkRunner& runner)
+{
+    Eigen::Vector4d sliders(0.1, 0.2, 0.3, 0.4);
+    Vector12d joint_velocities = Vector12d::LinSpaced(-1.0, 1.0);
+
+    RunningMeanFilter<4, 200> running_mean;
+    runner.run("filters_running_mean_4x200", [&running_mean, &sliders]() {
+        sliders(0) += 1e-6;
+        do_not_optimize(running_mean.filter(sliders));
+    });
+    FirstOrderLowPassFilter<12> first_order(50.0, 0.001);
+    runner.run("filters_first_order_12",
+               [&first_order, &joint_velocities]() {
+                   joint_velocities(0) += 1e-6;
+                   do_not_optimize(first_order.filter(joint_velocities));
+               });
+    SecondOrderLowPassFilter<12> second_order(50.0, 0.001);
+    runner.run("filters_second_order_12",
+               [&second_order, &joint_velocities]() {
+                   joint_velocities(0) += 1e-6;
+                   do_not_optimize(second_order.filter(joint_velocities));
+               });
+    MedianFilter<12, 5> median;
+    runner.run("filters_median_12x5", [&median, &joint_velocities]() {
+        joint_velocities(0) = -joint_velocities(0);
+        do_not_optimize(median.filter(joint_velocities));
+    });
+}
+
+/**
+ * @brief Logging of a joint vector from the control loop, compared to the
+ * legacy print_vector() formatting one element per call. Both write to
+ * /dev/null.
+ */
+void run_rt_logger_benchmarks(BenchmarkRunner& runner)
+{
+    if (!runner.is_selected("rt_logger_"))
+    {
+        return;
+    }
+    FILE* null_stream = std::fopen("/dev/null", "w");
+    if (null_stream == nullptr)
+    {
+        return;
+    }
+    Vector12d joint_positions = Vector12d::LinSpaced(-1.0, 1.0);
+    {
+        RtLogger logger(1 << 16, null_stream);
+        runner.run("rt_logger_log_vector_12", [&logger, &joint_positions]() {
+            do_not_optimize(logger.log_vector("joint_pos", joint_positions));
+        });
+    }
+    runner.run("rt_logger_legacy_print_vector_12",
+               [null_stream, &joint_positions]() {
+                   std::string v_name = "joint_pos";
+                   v_name += ": [";
+                   std::fprintf(null_stream, "%s", v_name.c_str());
+                   for (int i = 0; i < joint_positions.size(); ++i)
+                   {
+                       std::fprintf(null_stream, "%0.3f, ", joint_positions(i));
+                   }
+                   std::fprintf(null_stream, "]\n");
+               });
+    std::fclose(null_stream);
+}
+
+#ifndef SOLO_BENCHMARK_DGM
+void run_dgm_benchmarks(BenchmarkRunner&)
+{
+}
+#endif
+
+}  // namespace benchmarks
+}  // namespace solo
+
+int main(int argc, char** argv)
+{
+    uint64_t iterations = 100000;
+    std::string filter;
+    std::string json_file;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            json_file = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--iterations N] [--filter substring]"
+                         " [--json file]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    solo::benchmarks::BenchmarkRunner runner(iterations, filter);
+    solo::benchmarks::run_solo12_benchmarks(runner);
+    solo::benchmarks::run_spi_joint_modules_benchmarks<8>(runner);
+    solo::benchmarks::run_spi_joint_modules_benchmarks<12>(runner);
+    solo::benchmarks::run_spi_joint_modules_benchmarks<24>(runner);
+    solo::benchmarks::run_master_board_io_threads_benchmarks<2>(runner);
+    solo::benchmarks::run_master_board_io_threads_benchmarks<4>(runner);
+    solo::benchmarks::run_sliders_benchmarks(runner);
+    solo::benchmarks::run_filters_benchmarks(runner);
+    solo::benchmarks::run_rt_logger_benchmarks(runner);
+    solo::benchmarks::run_dgm_benchmarks(runner);
+
+    std::ostream& table = json_file.empty() ? std::cerr : std::cout;
+    table << std::left << std::setw(56) << "benchmark" << std::right
+          << std::setw(14) << "ns/op" << std::setw(14) << "allocs/op"
+          << std::setw(14) << "bytes/op" << std::endl;
+    for (const solo::benchmarks::BenchmarkResult& result :
+         runner.get_results())
+    {
+        table << std::left << std::setw(56) << result.name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14)
+              << result.ns_per_op << std::setprecision(2) << std::setw(14)
+              << result.allocations_per_op << std::setw(14)
+              << result.bytes_per_op << std::endl;
+    }
+    table.unsetf(std::ios::floatfield);
+
+    if (json_file.empty())
+    {
+        runner.write_json(std::cout);
+    }
+    else
+    {
+        std::ofstream stream(json_file);
+        runner.write_json(stream);
+    }
+    return 0;
+}
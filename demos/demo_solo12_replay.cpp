@@ -0,0 +1,80 @@
+/**
+ * @file demo_solo12_replay.cpp
+ * @brief Replay a Solo12 flight record through the slider PD controller.
+ * @date 2026-10-16
+ *
+ * The controller of demo_solo12 is run on every recorded cycle as fast as
+ * possible and its torques are compared with the recorded ones. Record a
+ * session with `./demo_solo12 network_id flight_record_file`.
+ */
+
+#include <chrono>
+
+#include "solo/common_programs_header.hpp"
+#include "solo/solo_replay.hpp"
+#include "solo12_slider_controller.hpp"
+
+using namespace solo;
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        throw std::runtime_error(
+            "Wrong number of argument: `./demo_solo12_replay "
+            "flight_record_file`.");
+    }
+
+    Solo12Replay robot;
+    robot.initialize(argv[1]);
+    if (robot.size() == 0)
+    {
+        rt_printf("The flight record %s is empty.\n", argv[1]);
+        return 0;
+    }
+    rt_printf("Replaying %zu cycles from %s (%s, %lu dropped).\n",
+              robot.size(),
+              argv[1],
+              robot.get_reader().is_clean_shutdown() ? "clean shutdown"
+                                                     : "recovered",
+              static_cast<unsigned long>(
+                  robot.get_reader().get_dropped_count()));
+
+    Solo12SliderController controller;
+    Vector12d desired_torque;
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    // The controller starts on the first recorded cycle, so the command of
+    // every recorded cycle is compared.
+    Solo12Replay::Frame first_frame;
+    robot.acquire_sensors();
+    robot.read_sensor_frame(first_frame);
+    controller.start(robot);
+    while (true)
+    {
+        desired_torque = controller.compute(robot);
+        robot.send_target_joint_torque(desired_torque);
+        if (robot.is_finished())
+        {
+            break;
+        }
+        robot.acquire_sensors();
+    }
+
+    double duration = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    Solo12Replay::Frame last_frame;
+    robot.read_sensor_frame(last_frame);
+    double recorded_duration = last_frame.timestamp - first_frame.timestamp;
+
+    rt_printf("Replayed %.3f s of recording in %.3f s (%.1fx real time).\n",
+              recorded_duration,
+              duration,
+              duration > 0.0 ? recorded_duration / duration : 0.0);
+    rt_printf("Max torque difference with the recording: %g Nm.\n",
+              robot.get_max_torque_difference());
+    return 0;
+}
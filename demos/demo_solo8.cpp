@@ -7,8 +7,8 @@
  * This file uses the Solo8 class in a small demo.
  */
 
-#include <numeric>
 #include "solo/common_programs_header.hpp"
+#include "solo/filters.hpp"
 #include "solo/solo8.hpp"
 #include "common_demo_header.hpp"
 
@@ -33,13 +33,8 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* thread_data_void_ptr)
     Eigen::Vector4d sliders_filt;
     Eigen::Vector4d sliders_init;
 
-    std::vector<std::deque<double> > sliders_filt_buffer(
-        robot->get_slider_positions().size());
-    size_t max_filt_dim = 100;
-    for (unsigned i = 0; i < sliders_filt_buffer.size(); ++i)
-    {
-        sliders_filt_buffer[i].clear();
-    }
+    // Moving average of the sliders over 100 cycles.
+    RunningMeanFilter<4, 100> sliders_filter;
 
     robot->acquire_sensors();
     sliders_init = robot->get_slider_positions();
@@ -49,6 +44,8 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* thread_data_void_ptr)
     solo::Vector8d joint_index_to_zero = thread_data_ptr->joint_index_to_zero;
     robot->request_calibration(joint_index_to_zero);
 
+    PeriodicExecutor executor(0.001);
+    executor.start();
     size_t count = 0;
     while (!CTRL_C_DETECTED)
     {
@@ -58,18 +55,7 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* thread_data_void_ptr)
         // aquire the slider signal
         sliders = robot->get_slider_positions();
         // filter it
-        for (unsigned i = 0; i < sliders_filt_buffer.size(); ++i)
-        {
-            if (sliders_filt_buffer[i].size() >= max_filt_dim)
-            {
-                sliders_filt_buffer[i].pop_front();
-            }
-            sliders_filt_buffer[i].push_back(sliders(i));
-            sliders_filt(i) = std::accumulate(sliders_filt_buffer[i].begin(),
-                                              sliders_filt_buffer[i].end(),
-                                              0.0) /
-                              (double)sliders_filt_buffer[i].size();
-        }
+        sliders_filt = sliders_filter.filter(sliders);
 
         // the slider goes from 0 to 1 so we go from -0.5rad to 0.5rad
         for (unsigned i = 0; i < 4; ++i)
@@ -91,8 +77,6 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* thread_data_void_ptr)
         // Send the current to the motor
         robot->send_target_joint_torque(desired_torque);
 
-        real_time_tools::Timer::sleep_sec(0.001);
-
         // print -----------------------------------------------------------
         if ((count % 1000) == 0)
         {
@@ -107,6 +91,8 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* thread_data_void_ptr)
             print_vector("zero_joint_pos", current_index_to_zero);
         }
         ++count;
+
+        executor.wait();
     }  // endwhile
     return THREAD_FUNCTION_RETURN_VALUE;
 }  // end control_loop
@@ -133,6 +119,9 @@ int main(int argc, char** argv)
     std::shared_ptr<Solo8> robot = std::make_shared<Solo8>();
     robot->initialize(std::string(argv[1]));
 
+    // Skip the index search when the last calibration is still valid.
+    robot->enable_calibration_cache();
+
     ThreadCalibrationData_t thread_data(robot);
     thread.create_realtime_thread(&control_loop, &thread_data);
 
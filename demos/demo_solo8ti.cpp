@@ -7,8 +7,8 @@
  * This file uses the Solo8TI class in a small demo.
  */
 
-#include <numeric>
 #include "solo/common_programs_header.hpp"
+#include "solo/filters.hpp"
 #include "solo/solo8ti.hpp"
 
 using namespace solo;
@@ -26,13 +26,10 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
     Eigen::Vector4d sliders;
     Eigen::Vector4d sliders_filt;
 
-    std::vector<std::deque<double> > sliders_filt_buffer(
-        robot.get_slider_positions().size());
-    size_t max_filt_dim = 200;
-    for (unsigned i = 0; i < sliders_filt_buffer.size(); ++i)
-    {
-        sliders_filt_buffer[i].clear();
-    }
+    // Moving average of the sliders over 200 cycles.
+    RunningMeanFilter<4, 200> sliders_filter;
+    PeriodicExecutor executor(0.001);
+    executor.start();
     size_t count = 0;
     while (!CTRL_C_DETECTED)
     {
@@ -42,18 +39,7 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
         // aquire the slider signal
         sliders = robot.get_slider_positions();
         // filter it
-        for (unsigned i = 0; i < sliders_filt_buffer.size(); ++i)
-        {
-            if (sliders_filt_buffer[i].size() >= max_filt_dim)
-            {
-                sliders_filt_buffer[i].pop_front();
-            }
-            sliders_filt_buffer[i].push_back(sliders(i));
-            sliders_filt(i) = std::accumulate(sliders_filt_buffer[i].begin(),
-                                              sliders_filt_buffer[i].end(),
-                                              0.0) /
-                              (double)sliders_filt_buffer[i].size();
-        }
+        sliders_filt = sliders_filter.filter(sliders);
 
         // the slider goes from 0 to 1 so we go from -0.5rad to 0.5rad
         for (unsigned i = 0; i < 4; ++i)
@@ -73,8 +59,6 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
         robot.send_target_joint_torque(desired_torque);
 
         // print -----------------------------------------------------------
-        real_time_tools::Timer::sleep_sec(0.001);
-
         if ((count % 1000) == 0)
         {
             print_vector("des_joint_tau", desired_torque);
@@ -82,6 +66,8 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
             print_vector("des_joint_pos", desired_joint_position);
         }
         ++count;
+
+        executor.wait();
     }  // endwhile
     return THREAD_FUNCTION_RETURN_VALUE;
 }  // end control_loop
@@ -0,0 +1,164 @@
+/**
+ * @file solo12_slider_controller.hpp
+ * @brief PD controller following the slider values, shared by the Solo12
+ * hardware and replay demos.
+ * @date 2026-10-16
+ *
+ * The controller is templated on the robot type so that the very same code
+ * runs on Solo12 and on Solo12Replay.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "solo/common_header.hpp"
+#include "solo/filters.hpp"
+
+namespace solo
+{
+/**
+ * @brief Map the slider values to the 12 joint set points.
+ *
+ * @param sliders Raw slider positions in [0, 1].
+ * @param sliders_out One value per joint.
+ */
+inline void map_sliders(Eigen::Ref<Eigen::Vector4d> sliders,
+                        Eigen::Ref<Vector12d> sliders_out)
+{
+    double slider_A = sliders(0) - 0.5;
+    double slider_B = sliders(1);
+    for (int i = 0; i < 4; i++)
+    {
+        sliders_out(3 * i + 0) = slider_A;
+        sliders_out(3 * i + 1) = slider_B;
+        sliders_out(3 * i + 2) = 2. * (1. - slider_B);
+
+        if (i >= 2)
+        {
+            sliders_out(3 * i + 1) *= -1;
+            sliders_out(3 * i + 2) *= -1;
+        }
+    }
+    // Swap the hip direction.
+    sliders_out(3) *= -1;
+    sliders_out(9) *= -1;
+}
+
+/**
+ * @brief Small PD controller at the current level tracking the filtered
+ * slider positions.
+ */
+class Solo12SliderController
+{
+public:
+    Solo12SliderController()
+    {
+        // Using conversion from PD gains from example.cpp
+        kp_ = 5.0 * 9 * 0.025;
+        kd_ = 0.1 * 9 * 0.025;
+        max_range_ = M_PI;
+        desired_torque_.setZero();
+        desired_joint_position_.setZero();
+        sliders_filt_.setZero();
+        sliders_zero_.setZero();
+    }
+
+    /**
+     * @brief Use the current slider positions as zero. The sensors must have
+     * been acquired once.
+     *
+     * @param robot
+     */
+    template <class Robot>
+    void start(Robot& robot)
+    {
+        map_sliders(robot.get_slider_positions(), sliders_zero_);
+        sliders_filter_.reset();
+        desired_torque_.setZero();
+    }
+
+    /**
+     * @brief Compute the torques of the current cycle from the acquired
+     * sensors.
+     *
+     * @param robot
+     * @return const Vector12d& The desired joint torques (Nm).
+     */
+    template <class Robot>
+    const Vector12d& compute(Robot& robot)
+    {
+        // acquire the motor enabled signal.
+        const std::array<bool, 12>& motor_enabled = robot.get_motor_enabled();
+
+        map_sliders(robot.get_slider_positions(), sliders_);
+
+        // filter it
+        sliders_filt_ = sliders_filter_.filter(sliders_);
+
+        // the slider goes from 0 to 1 so we go from -0.5rad to 0.5rad
+        for (unsigned i = 0; i < sliders_filt_.size(); ++i)
+        {
+            desired_joint_position_(i) =
+                max_range_ * (sliders_filt_(i) - sliders_zero_(i));
+        }
+
+        // we implement here a small pd control at the current level
+        desired_torque_tmp_ =
+            kp_ * (desired_joint_position_ - robot.get_joint_positions()) -
+            kd_ * robot.get_joint_velocities();
+
+        // HACK: Due to unstable SPI, only update torque for enabled motors.
+        for (unsigned i = 0; i < sliders_filt_.size(); ++i)
+        {
+            if (motor_enabled[i])
+            {
+                desired_torque_(i) = desired_torque_tmp_(i);
+            }
+        }
+        return desired_torque_;
+    }
+
+    /** @brief Filtered slider values, one per joint. */
+    const Vector12d& get_sliders_filt() const
+    {
+        return sliders_filt_;
+    }
+
+    /** @brief Slider values used as zero, one per joint. */
+    const Vector12d& get_sliders_zero() const
+    {
+        return sliders_zero_;
+    }
+
+    /** @brief Desired joint positions of the last cycle (rad). */
+    const Vector12d& get_desired_joint_position() const
+    {
+        return desired_joint_position_;
+    }
+
+private:
+    /** @brief Proportional gain. */
+    double kp_;
+    /** @brief Derivative gain. */
+    double kd_;
+    /** @brief Joint range covered by the sliders (rad). */
+    double max_range_;
+    /** @brief Moving average of the slider values over 50 cycles. */
+    RunningMeanFilter<12, 50> sliders_filter_;
+
+    /** @brief Slider values of the current cycle. */
+    Vector12d sliders_;
+    /** @brief Filtered slider values. */
+    Vector12d sliders_filt_;
+    /** @brief Slider values at start. */
+    Vector12d sliders_zero_;
+    /** @brief Desired joint positions. */
+    Vector12d desired_joint_position_;
+    /** @brief Unmasked PD torques. */
+    Vector12d desired_torque_tmp_;
+    /** @brief Torques sent to the robot. */
+    Vector12d desired_torque_;
+};
+
+}  // namespace solo
@@ -0,0 +1,212 @@
+/**
+ * @file allocation_guard.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Detection of heap allocations inside the real time control path.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+#include <Eigen/Core>
+#endif
+
+namespace solo
+{
+/**
+ * @brief Marks a scope of the current thread in which no heap allocation is
+ * allowed.
+ *
+ * The guard itself only maintains a thread local scope name, so it costs a
+ * few instructions. The allocations are observed by the replacement of the
+ * global operator new of the solo_allocation_guard library, which calls
+ * on_allocation(): link it into an executable to check its control loop.
+ * Every allocation inside a guarded scope is counted as a violation and
+ * reported once per scope, or aborts the process if
+ * set_abort_on_violation(true) was called.
+ *
+ * Eigen does not go through operator new: its dynamic size matrices call
+ * std::malloc from Eigen::internal::aligned_malloc, which the replaced
+ * operator new never sees. Code compiled with EIGEN_RUNTIME_NO_MALLOC, like
+ * the robot libraries, also forbids the Eigen allocations while a guard is
+ * alive, through Eigen::internal::set_is_malloc_allowed(false). Eigen then
+ * fails an eigen_assert, which aborts, instead of reporting. This Eigen flag
+ * is shared by the whole process: while a guard is alive, an Eigen
+ * allocation of another thread compiled with EIGEN_RUNTIME_NO_MALLOC aborts
+ * too. A plain std::malloc call is seen by neither mechanism.
+ *
+ * Use SOLO_RT_ALLOCATION_GUARD() which compiles to nothing when NDEBUG is
+ * defined.
+ */
+class AllocationGuard
+{
+public:
+    /**
+     * @brief Enter a guarded scope.
+     *
+     * @param scope_name Name reported with the violations, must outlive the
+     * guard (a string literal).
+     */
+    explicit AllocationGuard(const char* scope_name)
+    {
+        previous_scope_name_ = scope_name_();
+        scope_name_() = scope_name;
+        scope_reported_() = false;
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        if (eigen_guard_count_().fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+            Eigen::internal::set_is_malloc_allowed(false);
+        }
+#endif
+    }
+
+    /**
+     * @brief Leave the guarded scope.
+     */
+    ~AllocationGuard()
+    {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        if (eigen_guard_count_().fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Eigen::internal::set_is_malloc_allowed(true);
+        }
+#endif
+        scope_name_() = previous_scope_name_;
+    }
+
+    AllocationGuard(const AllocationGuard&) = delete;
+    AllocationGuard& operator=(const AllocationGuard&) = delete;
+
+    /**
+     * @brief Called by the replaced operator new for every allocation.
+     *
+     * Never allocates.
+     *
+     * @param size Number of bytes requested.
+     */
+    static void on_allocation(std::size_t size)
+    {
+        const char* scope_name = scope_name_();
+        if (scope_name == nullptr)
+        {
+            return;
+        }
+        violation_count_().fetch_add(1, std::memory_order_relaxed);
+        if (abort_on_violation_().load(std::memory_order_relaxed))
+        {
+            std::fprintf(stderr,
+                         "AllocationGuard: allocation of %zu bytes in %s, "
+                         "aborting.\n",
+                         size,
+                         scope_name);
+            std::abort();
+        }
+        if (!scope_reported_())
+        {
+            scope_reported_() = true;
+            std::fprintf(stderr,
+                         "AllocationGuard: allocation of %zu bytes in %s.\n",
+                         size,
+                         scope_name);
+        }
+    }
+
+    /**
+     * @brief Number of allocations detected in guarded scopes, by all the
+     * threads.
+     */
+    static uint64_t get_violation_count()
+    {
+        return violation_count_().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Abort at the first allocation in a guarded scope instead of
+     * printing a message.
+     */
+    static void set_abort_on_violation(bool abort_on_violation)
+    {
+        abort_on_violation_().store(abort_on_violation,
+                                    std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Name of the guarded scope of the current thread, nullptr if
+     * none.
+     */
+    static const char* get_scope_name()
+    {
+        return scope_name_();
+    }
+
+private:
+    /*
+     * Function local statics so that the state is shared by all the shared
+     * libraries including this header.
+     */
+
+    static const char*& scope_name_()
+    {
+        static thread_local const char* scope_name = nullptr;
+        return scope_name;
+    }
+
+    static bool& scope_reported_()
+    {
+        static thread_local bool scope_reported = false;
+        return scope_reported;
+    }
+
+    static std::atomic<uint64_t>& violation_count_()
+    {
+        static std::atomic<uint64_t> violation_count(0);
+        return violation_count;
+    }
+
+    static std::atomic<bool>& abort_on_violation_()
+    {
+        static std::atomic<bool> abort_on_violation(false);
+        return abort_on_violation;
+    }
+
+    /**
+     * @brief Number of guards alive in all the threads, the Eigen flag is
+     * process wide.
+     */
+    static std::atomic<int>& eigen_guard_count_()
+    {
+        static std::atomic<int> eigen_guard_count(0);
+        return eigen_guard_count;
+    }
+
+    /** @brief Scope name to restore, guards can be nested. */
+    const char* previous_scope_name_;
+};
+
+}  // namespace solo
+
+#define SOLO_ALLOCATION_GUARD_CONCAT_(a, b) a##b
+#define SOLO_ALLOCATION_GUARD_CONCAT(a, b) SOLO_ALLOCATION_GUARD_CONCAT_(a, b)
+
+/**
+ * @brief Forbid heap allocations until the end of the current scope, in
+ * debug builds only.
+ *
+ * @param scope_name String literal naming the scope.
+ */
+#ifdef NDEBUG
+#define SOLO_RT_ALLOCATION_GUARD(scope_name)
+#else
+#define SOLO_RT_ALLOCATION_GUARD(scope_name)                         \
+    ::solo::AllocationGuard SOLO_ALLOCATION_GUARD_CONCAT(            \
+        solo_allocation_guard_, __LINE__)(scope_name)
+#endif
@@ -0,0 +1,316 @@
+/**
+ * @file calibration_cache.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Persistence of the last joint calibration across restarts.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+#include <Eigen/Eigen>
+
+#include "solo/seqlock.hpp"
+
+namespace solo
+{
+/**
+ * @brief Last successful joint calibration of a robot, stored in a yaml
+ * file.
+ *
+ * The file holds:
+ * - the robot name and a fingerprint of its compiled configuration (joint
+ *   count, motor numbers and directions, gear ratio), so a cache written by
+ *   a build for another wiring is ignored. It does not identify the
+ *   physical robot nor its boards,
+ * - the home offsets of the last successful calibration.
+ *
+ * On restart SoloRobot only trusts the cache for the same home offsets and
+ * if the motor boards still report every encoder index as detected, i.e.
+ * they kept the index positions of that calibration, otherwise it runs the
+ * full index search.
+ *
+ * post() is real time safe: a background thread writes the posted offsets
+ * to the file. load() and save() do file I/O: never call them from the real
+ * time loop.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ */
+template <int JOINT_COUNT>
+class CalibrationCache
+{
+public:
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+
+    /**
+     * @brief Construct an empty cache, see load().
+     *
+     * @param file_path Path of the yaml file.
+     * @param robot_name Name of the robot, e.g. "Solo12".
+     * @param config_fingerprint Fingerprint of the robot configuration.
+     */
+    CalibrationCache(const std::string& file_path,
+                     const std::string& robot_name,
+                     uint64_t config_fingerprint)
+        : file_path_(file_path), robot_name_(robot_name)
+    {
+        config_fingerprint_ = config_fingerprint;
+        is_valid_ = false;
+        home_offsets_.setZero();
+        saved_version_ = 0;
+        is_running_ = true;
+        writer_thread_ = std::thread(&CalibrationCache::writer_loop, this);
+    }
+
+    /**
+     * @brief Write the offsets posted last, if not written yet.
+     */
+    ~CalibrationCache()
+    {
+        is_running_ = false;
+        writer_thread_.join();
+        write_posted();
+    }
+
+    /**
+     * @brief Read the file.
+     *
+     * @return true if the file exists and was written for this robot and
+     * configuration.
+     */
+    bool load()
+    {
+        is_valid_ = false;
+        try
+        {
+            const YAML::Node node = YAML::LoadFile(file_path_);
+            if (node["robot"].as<std::string>() != robot_name_ ||
+                node["config_fingerprint"].as<std::string>() !=
+                    to_hex(config_fingerprint_))
+            {
+                return false;
+            }
+            if (!read_vector(node["home_offsets"], home_offsets_))
+            {
+                return false;
+            }
+        }
+        catch (const YAML::Exception&)
+        {
+            return false;
+        }
+        is_valid_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Record a successful calibration, written to the file by the
+     * background thread within a few tens of milliseconds. Real time safe,
+     * call it from the thread calling is_valid_for().
+     *
+     * @param home_offsets Home offsets of the calibration (rad).
+     */
+    void post(const JointVector& home_offsets)
+    {
+        home_offsets_ = home_offsets;
+        is_valid_ = true;
+        posted_offsets_.write(home_offsets);
+    }
+
+    /**
+     * @brief Write the file now, through a temporary file renamed over the
+     * previous one so a crash never leaves a truncated cache. Does not
+     * change what is_valid_for() accepts, see post().
+     *
+     * @param home_offsets Home offsets of the calibration (rad).
+     * @return false if the file could not be written.
+     */
+    bool save(const JointVector& home_offsets)
+    {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        const std::string temporary_path = file_path_ + ".tmp";
+        FILE* file = std::fopen(temporary_path.c_str(), "w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        std::fprintf(file, "# Joint calibration cache, written by %s.\n",
+                     robot_name_.c_str());
+        std::fprintf(file, "robot: %s\n", robot_name_.c_str());
+        std::fprintf(file,
+                     "config_fingerprint: \"%s\"\n",
+                     to_hex(config_fingerprint_).c_str());
+        write_vector(file, "home_offsets", home_offsets);
+        const bool written = std::fclose(file) == 0;
+        if (!written ||
+            std::rename(temporary_path.c_str(), file_path_.c_str()) != 0)
+        {
+            std::remove(temporary_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief If the cache was loaded or posted for these home offsets.
+     * Allocation free.
+     *
+     * @param home_offsets (rad)
+     */
+    bool is_valid_for(const JointVector& home_offsets) const
+    {
+        return is_valid_ &&
+               (home_offsets - home_offsets_).cwiseAbs().maxCoeff() < 1e-9;
+    }
+
+    /** @brief Home offsets of the cached calibration (rad). */
+    const JointVector& get_home_offsets() const
+    {
+        return home_offsets_;
+    }
+
+    /** @brief Path of the yaml file. */
+    const std::string& get_file_path() const
+    {
+        return file_path_;
+    }
+
+    /**
+     * @brief Default location of the cache of a robot:
+     * $HOME/.<robot_name>_calibration_cache.yaml, in lower case.
+     *
+     * @param robot_name
+     */
+    static std::string get_default_path(const std::string& robot_name)
+    {
+        const char* home = std::getenv("HOME");
+        std::string file_name = "." + robot_name + "_calibration_cache.yaml";
+        for (char& c : file_name)
+        {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return std::string(home != nullptr ? home : "/tmp") + "/" + file_name;
+    }
+
+    /**
+     * @brief Extend a 64 bit FNV-1a hash, to build the configuration
+     * fingerprint.
+     *
+     * @param hash Current hash, 14695981039346656037 to start.
+     * @param data
+     * @param size Size of data in bytes.
+     */
+    static uint64_t hash(uint64_t hash, const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+private:
+    /**
+     * @brief Background thread: write the posted offsets.
+     */
+    void writer_loop()
+    {
+        while (is_running_.load())
+        {
+            write_posted();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    /**
+     * @brief Write the offsets posted last, if not written yet.
+     */
+    void write_posted()
+    {
+        if (posted_offsets_.get_version() == saved_version_)
+        {
+            return;
+        }
+        JointVector home_offsets;
+        saved_version_ = posted_offsets_.read(home_offsets);
+        if (!save(home_offsets))
+        {
+            printf("%s: could not write the calibration cache %s\n",
+                   robot_name_.c_str(),
+                   file_path_.c_str());
+        }
+    }
+
+    static std::string to_hex(uint64_t value)
+    {
+        char buffer[17];
+        std::snprintf(
+            buffer, sizeof(buffer), "%016llx", (unsigned long long)value);
+        return buffer;
+    }
+
+    static bool read_vector(const YAML::Node& node, JointVector& vector)
+    {
+        const std::vector<double> values = node.as<std::vector<double> >();
+        if (values.size() != JOINT_COUNT)
+        {
+            return false;
+        }
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            vector(i) = values[i];
+        }
+        return true;
+    }
+
+    static void write_vector(FILE* file,
+                             const char* name,
+                             const JointVector& vector)
+    {
+        std::fprintf(file, "%s: [", name);
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            std::fprintf(file, i == 0 ? "%.17g" : ", %.17g", vector(i));
+        }
+        std::fprintf(file, "]\n");
+    }
+
+    /** @brief Path of the yaml file. */
+    std::string file_path_;
+    /** @brief Name of the robot. */
+    std::string robot_name_;
+    /** @brief Fingerprint of the robot configuration. */
+    uint64_t config_fingerprint_;
+    /** @brief If the cached values were loaded or posted. */
+    bool is_valid_;
+    /** @brief Home offsets of the cached calibration (rad). */
+    JointVector home_offsets_;
+    /** @brief Offsets posted to the writer thread (rad). */
+    SeqLock<JointVector> posted_offsets_;
+    /** @brief Version of posted_offsets_ last written, writer thread only. */
+    uint64_t saved_version_;
+    /** @brief Serializes the writes of the file. */
+    std::mutex file_mutex_;
+    /** @brief Cleared to stop the writer thread. */
+    std::atomic_bool is_running_;
+    /** @brief Writes the posted offsets. */
+    std::thread writer_thread_;
+};
+
+}  // namespace solo
@@ -0,0 +1,246 @@
+/**
+ * @file can_bus_telemetry.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Frame counters and utilization of a blmc_drivers CAN bus.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include <blmc_drivers/devices/can_bus.hpp>
+
+namespace solo
+{
+/**
+ * @brief Traffic of one CAN bus, see CanBusTelemetry.
+ */
+struct CanBusStatistics
+{
+    CanBusStatistics()
+    {
+        tx_frame_count = 0;
+        tx_byte_count = 0;
+        rx_frame_count = 0;
+        rx_byte_count = 0;
+        utilization = 0.0;
+        max_utilization = 0.0;
+        tx_queue_depth = 0;
+        max_tx_queue_depth = 0;
+        tx_replaced_count = 0;
+    }
+
+    /** @brief Number of frames sent. */
+    uint64_t tx_frame_count;
+    /** @brief Number of data bytes sent. */
+    uint64_t tx_byte_count;
+    /** @brief Number of frames received. */
+    uint64_t rx_frame_count;
+    /** @brief Number of data bytes received. */
+    uint64_t rx_byte_count;
+    /**
+     * @brief Share of the bus bandwidth used by the frames sent and received
+     * during the last window (%), ignoring the bit stuffing.
+     */
+    double utilization;
+    /** @brief Largest utilization of a window (%). */
+    double max_utilization;
+    /**
+     * @brief Number of frames queued to the bus and not sent yet, at the
+     * last update: 0 or 1, the bus only keeps the newest frame to send.
+     */
+    long tx_queue_depth;
+    /** @brief Largest tx_queue_depth seen. */
+    long max_tx_queue_depth;
+    /** @brief Number of frames replaced by a newer one before being sent. */
+    uint64_t tx_replaced_count;
+};
+
+/**
+ * @brief Count the frames going through a CAN bus from the time series of
+ * blmc_drivers::CanBus.
+ *
+ * Every update() only reads the frames added to the time series since the
+ * previous one, a handful per control cycle, and never allocates. The
+ * utilization is averaged over windows of a fixed duration.
+ *
+ * Not thread safe: update and read from the control thread.
+ */
+class CanBusTelemetry
+{
+public:
+    typedef blmc_drivers::CanBusInterface::CanframeTimeseries FrameSeries;
+
+    /**
+     * @brief Construct a detached telemetry, see attach().
+     *
+     * @param bitrate Bit rate of the bus (bit/s).
+     * @param window Duration over which the utilization is averaged (s).
+     */
+    CanBusTelemetry(double bitrate = 1e6, double window = 0.1)
+    {
+        bitrate_ = bitrate;
+        window_ = window;
+        reset_indexes();
+    }
+
+    /**
+     * @brief Start counting the frames of a bus. The frames already in its
+     * history are not counted.
+     *
+     * @param can_bus
+     * @param bitrate Bit rate of the bus (bit/s).
+     */
+    void attach(std::shared_ptr<blmc_drivers::CanBus> can_bus,
+                double bitrate = 1e6)
+    {
+        can_bus_ = can_bus;
+        bitrate_ = bitrate;
+        statistics_ = CanBusStatistics();
+        reset_indexes();
+        if (can_bus_)
+        {
+            last_rx_index_ = newest_index(*can_bus_->get_output_frame());
+            last_tx_index_ = newest_index(*can_bus_->get_sent_input_frame());
+            first_input_index_ = newest_index(*can_bus_->get_input_frame());
+        }
+    }
+
+    /**
+     * @brief Count the new frames.
+     *
+     * @param now Current time (s), any monotonic clock.
+     */
+    void update(double now)
+    {
+        if (!can_bus_)
+        {
+            return;
+        }
+        count_new_frames(*can_bus_->get_output_frame(),
+                         last_rx_index_,
+                         statistics_.rx_frame_count,
+                         statistics_.rx_byte_count);
+        count_new_frames(*can_bus_->get_sent_input_frame(),
+                         last_tx_index_,
+                         statistics_.tx_frame_count,
+                         statistics_.tx_byte_count);
+        // The bus tags its input series when it sends the newest frame, the
+        // older untagged ones are never sent.
+        const FrameSeries& inputs = *can_bus_->get_input_frame();
+        statistics_.tx_queue_depth =
+            inputs.length() != 0 && inputs.has_changed_since_tag() ? 1 : 0;
+        statistics_.max_tx_queue_depth = std::max(
+            statistics_.max_tx_queue_depth, statistics_.tx_queue_depth);
+        const uint64_t input_count = newest_index(inputs) - first_input_index_;
+        const uint64_t handled_count =
+            statistics_.tx_frame_count + statistics_.tx_queue_depth;
+        statistics_.tx_replaced_count =
+            input_count > handled_count ? input_count - handled_count : 0;
+
+        if (window_start_ < 0.0)
+        {
+            window_start_ = now;
+            window_bit_count_ = 0;
+        }
+        else if (now - window_start_ >= window_)
+        {
+            statistics_.utilization = 100.0 *
+                                      static_cast<double>(window_bit_count_) /
+                                      (bitrate_ * (now - window_start_));
+            statistics_.max_utilization =
+                std::max(statistics_.max_utilization, statistics_.utilization);
+            window_start_ = now;
+            window_bit_count_ = 0;
+        }
+    }
+
+    /** @brief The counters at the last update(). */
+    const CanBusStatistics& get_statistics() const
+    {
+        return statistics_;
+    }
+
+    /**
+     * @brief Number of bits of a standard CAN frame on the wire, without
+     * the bit stuffing: 47 bits of framing plus the data.
+     *
+     * @param data_length Number of data bytes.
+     */
+    static int frame_bit_count(int data_length)
+    {
+        return 47 + 8 * data_length;
+    }
+
+private:
+    static time_series::Index newest_index(const FrameSeries& series)
+    {
+        return series.length() == 0 ? -1 : series.newest_timeindex(false);
+    }
+
+    /**
+     * @brief Add the frames after last_index to the counters.
+     */
+    void count_new_frames(const FrameSeries& series,
+                          time_series::Index& last_index,
+                          uint64_t& frame_count,
+                          uint64_t& byte_count)
+    {
+        const time_series::Index newest = newest_index(series);
+        if (newest <= last_index)
+        {
+            return;
+        }
+        frame_count += newest - last_index;
+        // Frames already out of the history are assumed full.
+        time_series::Index index =
+            std::max(last_index + 1, series.oldest_timeindex(false));
+        const uint64_t lost_count = index - (last_index + 1);
+        byte_count += 8 * lost_count;
+        window_bit_count_ += lost_count * frame_bit_count(8);
+        for (; index <= newest; ++index)
+        {
+            const int data_length = series[index].dlc;
+            byte_count += data_length;
+            window_bit_count_ += frame_bit_count(data_length);
+        }
+        last_index = newest;
+    }
+
+    void reset_indexes()
+    {
+        last_rx_index_ = -1;
+        last_tx_index_ = -1;
+        first_input_index_ = -1;
+        window_start_ = -1.0;
+        window_bit_count_ = 0;
+    }
+
+    /** @brief The observed bus, may be null. */
+    std::shared_ptr<blmc_drivers::CanBus> can_bus_;
+    /** @brief Bit rate of the bus (bit/s). */
+    double bitrate_;
+    /** @brief Duration over which the utilization is averaged (s). */
+    double window_;
+    /** @brief Last received frame counted. */
+    time_series::Index last_rx_index_;
+    /** @brief Last sent frame counted. */
+    time_series::Index last_tx_index_;
+    /** @brief Newest frame to send at attach(). */
+    time_series::Index first_input_index_;
+    /** @brief Start of the current window (s), negative before the first
+     * update. */
+    double window_start_;
+    /** @brief Bits sent and received during the current window. */
+    uint64_t window_bit_count_;
+    /** @brief The counters. */
+    CanBusStatistics statistics_;
+};
+
+}  // namespace solo
@@ -11,6 +11,8 @@
 #pragma once
 
 #include "solo/common_header.hpp"
+#include "solo/periodic_executor.hpp"
+#include "solo/rt_logger.hpp"
 
 namespace solo
 {
@@ -19,6 +21,11 @@ namespace solo
  */
 std::atomic_bool CTRL_C_DETECTED(false);
 
+/**
+ * @brief Logger of the demos and programs, writes to stdout.
+ */
+RtLogger RT_LOGGER(4096);
+
 /**
  * @brief This function is the callback upon a ctrl+c call from the terminal.
  *
@@ -47,18 +54,16 @@ void enable_ctrl_c()
  * @brief Usefull tool for the demos and programs in order to print data in
  * real time.
  *
- * @param v_name  is a string defining the data to print.
+ * The vector is queued to RT_LOGGER, it is formatted and printed by the
+ * logger thread.
+ *
+ * @param v_name is a string literal defining the data to print.
  * @param v the vector to print.
  */
-void print_vector(std::string v_name, const Eigen::Ref<const Eigen::VectorXd> v)
+template <class Derived>
+void print_vector(const char* v_name, const Eigen::MatrixBase<Derived>& v)
 {
-    v_name += ": [";
-    rt_printf("%s", v_name.c_str());
-    for (int i = 0; i < v.size(); ++i)
-    {
-        rt_printf("%0.3f, ", v(i));
-    }
-    rt_printf("]\n");
+    RT_LOGGER.log_vector(v_name, v);
 }
 
 }  // namespace solo
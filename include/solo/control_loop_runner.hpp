@@ -0,0 +1,452 @@
+/**
+ * @file control_loop_runner.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Real time joint control loop driven by a slower policy.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <Eigen/Eigen>
+
+#include "solo/allocation_guard.hpp"
+#include "solo/periodic_executor.hpp"
+#include "solo/sensor_frame.hpp"
+#include "solo/seqlock.hpp"
+
+namespace solo
+{
+/**
+ * @brief Joint targets tracked by the ControlLoopRunner between two policy
+ * updates.
+ *
+ * The torque sent at every cycle is
+ * torques + kp * (positions - q) + kd * (velocities - dq).
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ */
+template <int JOINT_COUNT>
+struct JointCommand
+{
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+
+    JointCommand()
+    {
+        positions.setZero();
+        velocities.setZero();
+        torques.setZero();
+        kp.setZero();
+        kd.setZero();
+        timestamp = 0.0;
+        sequence = 0;
+    }
+
+    /** @brief Desired joint positions (rad). */
+    JointVector positions;
+    /** @brief Desired joint velocities (rad/s). */
+    JointVector velocities;
+    /** @brief Feed forward joint torques (Nm). */
+    JointVector torques;
+    /** @brief Proportional gains (Nm/rad). */
+    JointVector kp;
+    /** @brief Derivative gains (Nm s/rad). */
+    JointVector kd;
+    /** @brief Time of the update, set by the runner (s), see
+     * SensorFrame::now(). */
+    double timestamp;
+    /** @brief Index of the update, set by the runner, starts at 1. */
+    uint64_t sequence;
+};
+
+/**
+ * @brief Rates and safety settings of the ControlLoopRunner.
+ */
+struct ControlLoopRunnerConfig
+{
+    ControlLoopRunnerConfig()
+    {
+        control_period = 0.001;
+        policy_period = 0.01;
+        command_timeout = 0.1;
+        safety_damping = 0.2;
+        control_thread_priority = 80;
+    }
+
+    /** @brief Period of the joint control loop (s). */
+    double control_period;
+    /** @brief Period of the policy calls (s). */
+    double policy_period;
+    /**
+     * @brief Age of the last command after which the loop falls back to
+     * damping (s). Until then the last command is held.
+     */
+    double command_timeout;
+    /** @brief Damping gain applied after the command timeout (Nm s/rad). */
+    double safety_damping;
+    /** @brief SCHED_FIFO priority of the control thread. */
+    int control_thread_priority;
+};
+
+/**
+ * @brief Own the real time thread of a robot and run a joint impedance loop,
+ * fed with targets by a slower policy.
+ *
+ * The control thread acquires the sensors, applies the latest JointCommand
+ * and sends the torques at control_period. The policy, e.g. a Python
+ * callback, runs on its own thread at policy_period: it gets the latest
+ * sensor frame and fills a new command. The commands go through a SeqLock
+ * mailbox, so a slow policy, an interpreter pause or a garbage collection
+ * never blocks the control thread.
+ *
+ * When the policy misses its deadline the control thread keeps tracking the
+ * last command and counts the stale cycles. After command_timeout without a
+ * new command it falls back to pure damping, until the next command.
+ *
+ * @tparam Robot A SoloRobot, e.g. Solo12. It must be initialized before
+ * start().
+ */
+template <class Robot>
+class ControlLoopRunner
+{
+public:
+    typedef typename Robot::JointVector JointVector;
+    typedef typename Robot::Frame Frame;
+    typedef JointCommand<Robot::joint_count> Command;
+    /** @brief Policy called with the latest frame, fills the command. */
+    typedef std::function<void(const Frame&, Command&)> Policy;
+
+    /**
+     * @brief Construct a stopped runner.
+     *
+     * @param robot Initialized robot, only used by the control thread once
+     * started.
+     * @param config
+     */
+    ControlLoopRunner(std::shared_ptr<Robot> robot,
+                      const ControlLoopRunnerConfig& config =
+                          ControlLoopRunnerConfig())
+        : robot_(robot),
+          config_(config),
+          control_executor_(config.control_period, overrun_skip),
+          policy_executor_(config.policy_period, overrun_skip)
+    {
+        if (!robot_)
+        {
+            throw std::runtime_error("ControlLoopRunner: no robot given.");
+        }
+        command_sequence_ = 0;
+        is_running_ = false;
+        cycle_count_ = 0;
+        control_overrun_count_ = 0;
+        stale_cycle_count_ = 0;
+        is_damping_ = false;
+        policy_call_count_ = 0;
+        policy_overrun_count_ = 0;
+        torques_.setZero();
+    }
+
+    /**
+     * @brief Stop the threads.
+     */
+    ~ControlLoopRunner()
+    {
+        stop();
+    }
+
+    ControlLoopRunner(const ControlLoopRunner&) = delete;
+    ControlLoopRunner& operator=(const ControlLoopRunner&) = delete;
+
+    /**
+     * @brief Set the policy called at policy_period. Must be called before
+     * start(). Without a policy the commands come from set_command().
+     *
+     * @param policy
+     */
+    void set_policy(Policy policy)
+    {
+        if (is_running_)
+        {
+            throw std::runtime_error(
+                "ControlLoopRunner::set_policy must be called before start.");
+        }
+        policy_ = policy;
+    }
+
+    /**
+     * @brief Start the control thread, and the policy thread if a policy is
+     * set.
+     */
+    void start()
+    {
+        if (is_running_.exchange(true))
+        {
+            return;
+        }
+        control_thread_ =
+            std::thread(&ControlLoopRunner::control_thread_loop, this);
+        sched_param parameters;
+        parameters.sched_priority = config_.control_thread_priority;
+        pthread_setschedparam(
+            control_thread_.native_handle(), SCHED_FIFO, &parameters);
+        if (policy_)
+        {
+            policy_thread_ =
+                std::thread(&ControlLoopRunner::policy_thread_loop, this);
+        }
+    }
+
+    /**
+     * @brief Stop and join the threads.
+     */
+    void stop()
+    {
+        if (!is_running_.exchange(false))
+        {
+            return;
+        }
+        if (policy_thread_.joinable())
+        {
+            policy_thread_.join();
+        }
+        control_thread_.join();
+    }
+
+    /** @brief If the threads are running. */
+    bool is_running() const
+    {
+        return is_running_;
+    }
+
+    /**
+     * @brief Post a new command to the control thread, when the runner has
+     * no policy. It must always be called from the same thread.
+     *
+     * @param command The timestamp and sequence are set by the runner.
+     * @throw std::runtime_error if a policy is set: the policy thread is then
+     * the only writer of the command mailbox.
+     */
+    void set_command(const Command& command)
+    {
+        if (policy_)
+        {
+            throw std::runtime_error(
+                "ControlLoopRunner::set_command cannot be used with a "
+                "policy.");
+        }
+        post_command(command);
+    }
+
+    /**
+     * @brief Copy the latest sensor frame published by the robot. Thread safe.
+     *
+     * @param[out] frame
+     * @return uint64_t The number of frames published so far.
+     */
+    uint64_t read_frame(Frame& frame) const
+    {
+        return robot_->read_sensor_frame(frame);
+    }
+
+    /** @brief Number of control cycles run. */
+    uint64_t get_cycle_count() const
+    {
+        return cycle_count_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Number of control cycles that ended after their deadline. */
+    uint64_t get_control_overrun_count() const
+    {
+        return control_overrun_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of control cycles run on a command older than a policy
+     * period, i.e. after a policy deadline miss.
+     */
+    uint64_t get_stale_cycle_count() const
+    {
+        return stale_cycle_count_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief If the command timed out and the loop only damps. */
+    bool is_damping() const
+    {
+        return is_damping_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Number of policy calls. */
+    uint64_t get_policy_call_count() const
+    {
+        return policy_call_count_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Number of policy calls that ended after their deadline. */
+    uint64_t get_policy_overrun_count() const
+    {
+        return policy_overrun_count_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief The settings of the runner. */
+    const ControlLoopRunnerConfig& get_config() const
+    {
+        return config_;
+    }
+
+private:
+    /**
+     * @brief Post a command to the mailbox, from its single writer.
+     */
+    void post_command(const Command& command)
+    {
+        posted_command_ = command;
+        posted_command_.timestamp = Frame::now();
+        posted_command_.sequence = ++command_sequence_;
+        command_mailbox_.write(posted_command_);
+    }
+
+    /**
+     * @brief One cycle of the control thread.
+     */
+    void step()
+    {
+        SOLO_RT_ALLOCATION_GUARD("ControlLoopRunner::step");
+
+        robot_->acquire_sensors();
+        command_mailbox_.read(command_);
+
+        const double command_age = Frame::now() - command_.timestamp;
+        const bool timed_out =
+            command_.sequence == 0 || command_age > config_.command_timeout;
+        if (timed_out)
+        {
+            torques_ = -config_.safety_damping * robot_->get_joint_velocities();
+        }
+        else
+        {
+            torques_ =
+                command_.torques +
+                command_.kp.cwiseProduct(command_.positions -
+                                         robot_->get_joint_positions()) +
+                command_.kd.cwiseProduct(command_.velocities -
+                                         robot_->get_joint_velocities());
+        }
+        robot_->send_target_joint_torque(torques_);
+
+        if (command_.sequence != 0 && command_age > config_.policy_period)
+        {
+            stale_cycle_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        is_damping_.store(timed_out, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Body of the control thread.
+     */
+    void control_thread_loop()
+    {
+        control_executor_.start();
+        while (is_running_)
+        {
+            step();
+            control_executor_.wait();
+            cycle_count_.store(control_executor_.get_cycle_count(),
+                               std::memory_order_relaxed);
+            control_overrun_count_.store(control_executor_.get_overrun_count(),
+                                         std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Body of the policy thread.
+     */
+    void policy_thread_loop()
+    {
+        policy_executor_.start();
+        while (is_running_)
+        {
+            robot_->read_sensor_frame(policy_frame_);
+            policy_command_ = posted_command_;
+            try
+            {
+                policy_(policy_frame_, policy_command_);
+            }
+            catch (const std::exception& exception)
+            {
+                // Keep the control thread alive, it will time out to damping.
+                std::fprintf(stderr,
+                             "ControlLoopRunner: the policy failed, no more "
+                             "commands: %s\n",
+                             exception.what());
+                return;
+            }
+            post_command(policy_command_);
+            policy_call_count_.fetch_add(1, std::memory_order_relaxed);
+            if (!policy_executor_.wait())
+            {
+                policy_overrun_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** @brief The controlled robot. */
+    std::shared_ptr<Robot> robot_;
+    /** @brief Rates and safety settings. */
+    ControlLoopRunnerConfig config_;
+    /** @brief The policy, may be empty. */
+    Policy policy_;
+
+    /** @brief Mailbox between the command writer and the control thread. */
+    SeqLock<Command> command_mailbox_;
+    /** @brief Last command posted, writer thread only. */
+    Command posted_command_;
+    /** @brief Number of commands posted, writer thread only. */
+    uint64_t command_sequence_;
+
+    /** @brief Command applied by the control thread. */
+    Command command_;
+    /** @brief Torques sent by the control thread (Nm). */
+    JointVector torques_;
+    /** @brief Paces the control thread. */
+    PeriodicExecutor control_executor_;
+
+    /** @brief Frame given to the policy. */
+    Frame policy_frame_;
+    /** @brief Command filled by the policy. */
+    Command policy_command_;
+    /** @brief Paces the policy thread. */
+    PeriodicExecutor policy_executor_;
+
+    /** @brief Cleared to stop the threads. */
+    std::atomic_bool is_running_;
+    std::thread control_thread_;
+    std::thread policy_thread_;
+
+    /*
+     * Statistics, written by the threads, readable from anywhere.
+     */
+
+    std::atomic<uint64_t> cycle_count_;
+    std::atomic<uint64_t> control_overrun_count_;
+    std::atomic<uint64_t> stale_cycle_count_;
+    std::atomic_bool is_damping_;
+    std::atomic<uint64_t> policy_call_count_;
+    std::atomic<uint64_t> policy_overrun_count_;
+};
+
+}  // namespace solo
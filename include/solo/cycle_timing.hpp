@@ -0,0 +1,330 @@
+/**
+ * @file cycle_timing.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Allocation free latency histograms used to monitor the duration of
+ * the different phases of a control cycle.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace solo
+{
+/**
+ * @brief Fixed size histogram of durations in nanoseconds with a bounded
+ * relative error (HDR histogram layout).
+ *
+ * The values below 2 * SUB_BUCKET_COUNT ns are stored exactly. Above, every
+ * power of two is split into SUB_BUCKET_COUNT linear sub-buckets, which gives
+ * a relative precision of 1 / SUB_BUCKET_COUNT (~3%). Durations up to 2^36 ns
+ * (~68s) are resolved, longer ones land in the last bucket. Recording a value
+ * is O(1) and never allocates, so it is safe to use in the real time loop.
+ *
+ * The histogram is not thread safe: record and query from the same thread or
+ * make sure the writer is stopped before reading.
+ */
+class LatencyHistogram
+{
+public:
+    /** @brief Number of bits used for the linear sub-buckets. */
+    static constexpr int SUB_BUCKET_BITS = 5;
+    /** @brief Number of linear sub-buckets per power of two. */
+    static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    /** @brief Position of the highest resolved bit (2^36 ns ~ 68s). */
+    static constexpr int MAX_VALUE_BITS = 36;
+    /** @brief Total number of buckets. */
+    static constexpr int BUCKET_COUNT =
+        SUB_BUCKET_COUNT * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) +
+        SUB_BUCKET_COUNT;
+
+    /**
+     * @brief Construct an empty histogram.
+     *
+     * @param overrun_threshold_ns Durations strictly above this threshold are
+     * counted as overruns.
+     */
+    LatencyHistogram(
+        uint64_t overrun_threshold_ns = std::numeric_limits<uint64_t>::max())
+    {
+        overrun_threshold_ns_ = overrun_threshold_ns;
+        reset();
+    }
+
+    /**
+     * @brief Clear all the recorded values. The overrun threshold is kept.
+     */
+    void reset()
+    {
+        counts_.fill(0);
+        total_count_ = 0;
+        overrun_count_ = 0;
+        min_ns_ = std::numeric_limits<uint64_t>::max();
+        max_ns_ = 0;
+        sum_ns_ = 0.0;
+    }
+
+    /**
+     * @brief Add one duration to the histogram.
+     *
+     * @param duration_ns (ns)
+     */
+    void record(uint64_t duration_ns)
+    {
+        counts_[bucket_index(duration_ns)]++;
+        total_count_++;
+        sum_ns_ += static_cast<double>(duration_ns);
+        if (duration_ns < min_ns_)
+        {
+            min_ns_ = duration_ns;
+        }
+        if (duration_ns > max_ns_)
+        {
+            max_ns_ = duration_ns;
+        }
+        if (duration_ns > overrun_threshold_ns_)
+        {
+            overrun_count_++;
+        }
+    }
+
+    /**
+     * @brief Get the value at the given percentile.
+     *
+     * @param percentile in [0, 100], e.g. 99.9.
+     * @return uint64_t (ns) The highest value equivalent to the bucket
+     * containing the percentile, clamped to the maximum recorded value. Zero if
+     * the histogram is empty.
+     */
+    uint64_t get_percentile_ns(double percentile) const
+    {
+        if (total_count_ == 0)
+        {
+            return 0;
+        }
+        if (percentile >= 100.0)
+        {
+            return max_ns_;
+        }
+        if (percentile < 0.0)
+        {
+            percentile = 0.0;
+        }
+        uint64_t target_count = static_cast<uint64_t>(
+            std::ceil(percentile / 100.0 * static_cast<double>(total_count_)));
+        if (target_count < 1)
+        {
+            target_count = 1;
+        }
+        uint64_t cumulated_count = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+        {
+            cumulated_count += counts_[i];
+            if (cumulated_count >= target_count)
+            {
+                uint64_t value = bucket_highest_value(i);
+                return value < max_ns_ ? value : max_ns_;
+            }
+        }
+        return max_ns_;
+    }
+
+    /** @brief Median duration (ns). */
+    uint64_t get_p50_ns() const
+    {
+        return get_percentile_ns(50.0);
+    }
+
+    /** @brief 99th percentile of the durations (ns). */
+    uint64_t get_p99_ns() const
+    {
+        return get_percentile_ns(99.0);
+    }
+
+    /** @brief 99.9th percentile of the durations (ns). */
+    uint64_t get_p999_ns() const
+    {
+        return get_percentile_ns(99.9);
+    }
+
+    /** @brief Smallest recorded duration (ns), zero if empty. */
+    uint64_t get_min_ns() const
+    {
+        return total_count_ == 0 ? 0 : min_ns_;
+    }
+
+    /** @brief Largest recorded duration (ns). */
+    uint64_t get_max_ns() const
+    {
+        return max_ns_;
+    }
+
+    /** @brief Mean of the recorded durations (ns). */
+    double get_mean_ns() const
+    {
+        return total_count_ == 0 ? 0.0
+                                 : sum_ns_ / static_cast<double>(total_count_);
+    }
+
+    /** @brief Number of recorded durations. */
+    uint64_t get_count() const
+    {
+        return total_count_;
+    }
+
+    /** @brief Number of recorded durations above the overrun threshold. */
+    uint64_t get_overrun_count() const
+    {
+        return overrun_count_;
+    }
+
+    /** @brief Durations above this value are counted as overruns (ns). */
+    uint64_t get_overrun_threshold_ns() const
+    {
+        return overrun_threshold_ns_;
+    }
+
+    /**
+     * @brief Set the overrun threshold. Only affects the future records.
+     *
+     * @param overrun_threshold_ns (ns)
+     */
+    void set_overrun_threshold_ns(uint64_t overrun_threshold_ns)
+    {
+        overrun_threshold_ns_ = overrun_threshold_ns;
+    }
+
+private:
+    /**
+     * @brief Map a value to its bucket. The magnitude is the number of bits
+     * dropped from the value to fit it into the sub-buckets.
+     */
+    static int bucket_index(uint64_t value)
+    {
+        int magnitude = 0;
+        if (value >= 2 * SUB_BUCKET_COUNT)
+        {
+            int highest_bit = 63 - __builtin_clzll(value);
+            if (highest_bit > MAX_VALUE_BITS)
+            {
+                return BUCKET_COUNT - 1;
+            }
+            magnitude = highest_bit - SUB_BUCKET_BITS;
+        }
+        return SUB_BUCKET_COUNT * magnitude +
+               static_cast<int>(value >> magnitude);
+    }
+
+    /**
+     * @brief Highest value that maps to the given bucket.
+     */
+    static uint64_t bucket_highest_value(int index)
+    {
+        if (index < 2 * SUB_BUCKET_COUNT)
+        {
+            return static_cast<uint64_t>(index);
+        }
+        int magnitude = index / SUB_BUCKET_COUNT - 1;
+        uint64_t sub_bucket =
+            static_cast<uint64_t>(index - SUB_BUCKET_COUNT * magnitude);
+        return (sub_bucket << magnitude) + (uint64_t(1) << magnitude) - 1;
+    }
+
+    /** @brief Number of values per bucket. */
+    std::array<uint64_t, BUCKET_COUNT> counts_;
+    /** @brief Total number of values. */
+    uint64_t total_count_;
+    /** @brief Number of values above overrun_threshold_ns_. */
+    uint64_t overrun_count_;
+    /** @brief Overrun threshold (ns). */
+    uint64_t overrun_threshold_ns_;
+    /** @brief Smallest value (ns). */
+    uint64_t min_ns_;
+    /** @brief Largest value (ns). */
+    uint64_t max_ns_;
+    /** @brief Sum of all values used for the mean (ns). */
+    double sum_ns_;
+};
+
+/**
+ * @brief Collection of latency histograms, one per phase of a control cycle.
+ *
+ * @tparam PHASE_COUNT Number of monitored phases. The phases are indexed by
+ * an enum defined by the user of this class.
+ */
+template <int PHASE_COUNT>
+class CycleTimingStatistics
+{
+public:
+    /** @brief Clock used to measure the phases. */
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Get the current time point used as start of a phase.
+     */
+    static Clock::time_point now()
+    {
+        return Clock::now();
+    }
+
+    /**
+     * @brief Record the duration between start and now for the given phase.
+     *
+     * @param phase Index of the phase.
+     * @param start Start of the phase, see now().
+     * @return Clock::time_point The current time, which can be used as start
+     * of the next phase.
+     */
+    Clock::time_point record(int phase, const Clock::time_point& start)
+    {
+        Clock::time_point stop = Clock::now();
+        histograms_[phase].record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+                .count()));
+        return stop;
+    }
+
+    /**
+     * @brief Get the histogram of one phase.
+     */
+    const LatencyHistogram& get_histogram(int phase) const
+    {
+        return histograms_[phase];
+    }
+
+    /**
+     * @brief Set the overrun threshold of one phase.
+     *
+     * @param phase Index of the phase.
+     * @param overrun_threshold_ns (ns)
+     */
+    void set_overrun_threshold_ns(int phase, uint64_t overrun_threshold_ns)
+    {
+        histograms_[phase].set_overrun_threshold_ns(overrun_threshold_ns);
+    }
+
+    /**
+     * @brief Clear the recorded values of all phases.
+     */
+    void reset()
+    {
+        for (int i = 0; i < PHASE_COUNT; ++i)
+        {
+            histograms_[i].reset();
+        }
+    }
+
+private:
+    /** @brief One histogram per phase. */
+    std::array<LatencyHistogram, PHASE_COUNT> histograms_;
+};
+
+}  // namespace solo
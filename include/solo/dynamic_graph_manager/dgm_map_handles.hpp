@@ -0,0 +1,93 @@
+/**
+ * @file dgm_map_handles.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Precomputed access to the entries of the dynamic graph manager
+ * sensor and control maps.
+ */
+
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+#include "dynamic_graph_manager/dynamic_graph_manager.hpp"
+
+namespace solo
+{
+/**
+ * @brief Table of pointers to named entries of a VectorDGMap.
+ *
+ * The entries of a std::map never move while no entry is inserted or erased,
+ * and the dynamic graph manager always passes the same maps. The names are
+ * looked up once, at the first resolve() for a map, and the hardware loop
+ * then reads and writes the signals through the table without any string
+ * comparison.
+ *
+ * @tparam SIZE Number of entries.
+ * @tparam Map VectorDGMap, or const VectorDGMap for read only access.
+ */
+template <int SIZE, class Map = dynamic_graph_manager::VectorDGMap>
+class DGMapHandles
+{
+public:
+    /** @brief dynamicgraph::Vector, const for a const Map. */
+    typedef typename std::conditional<std::is_const<Map>::value,
+                                      const dynamicgraph::Vector,
+                                      dynamicgraph::Vector>::type Entry;
+
+    /**
+     * @brief Construct an unresolved table.
+     *
+     * @param names Name of each entry, strings with static lifetime.
+     */
+    explicit DGMapHandles(const std::array<const char*, SIZE>& names)
+        : names_(names)
+    {
+        map_ = nullptr;
+        entries_.fill(nullptr);
+    }
+
+    /**
+     * @brief Look the entries up if the map is not the one already resolved.
+     *
+     * @param map
+     * @throw std::out_of_range if an entry is missing, like VectorDGMap::at.
+     */
+    void resolve(Map& map)
+    {
+        if (&map == map_)
+        {
+            return;
+        }
+        map_ = nullptr;
+        for (int i = 0; i < SIZE; ++i)
+        {
+            entries_[i] = &map.at(names_[i]);
+        }
+        map_ = &map;
+    }
+
+    /**
+     * @brief Entry of the resolved map.
+     *
+     * @param index Position of the name given to the constructor.
+     */
+    Entry& operator[](int index) const
+    {
+        return *entries_[index];
+    }
+
+private:
+    /** @brief Name of each entry. */
+    std::array<const char*, SIZE> names_;
+    /** @brief The resolved map, nullptr before the first resolve(). */
+    Map* map_;
+    /** @brief The resolved entries. */
+    std::array<Entry*, SIZE> entries_;
+};
+
+}  // namespace solo
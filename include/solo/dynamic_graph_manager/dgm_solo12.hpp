@@ -9,115 +9,71 @@
  * Gesellshaft.
  */
 
-#ifndef DGM_SOLO_HH
-#define DGM_SOLO_HH
+#pragma once
 
+#include "solo/dynamic_graph_manager/dgm_solo_adapter.hpp"
 #include "solo/solo12.hpp"
-#include "mim_msgs/srv/joint_calibration.hpp"
-#include "dynamic_graph_manager/dynamic_graph_manager.hpp"
-#include "yaml_utils/yaml_cpp_fwd.hpp"
 
 namespace solo
 {
-class DGMSolo12 : public dynamic_graph_manager::DynamicGraphManager
+/**
+ * @brief Solo12 part of the DGMSolo12: IMU and slider box.
+ */
+template <>
+struct DGMSoloTraits<Solo12>
 {
-public:
-    /**
-     * @brief DemoSingleMotor is the constructor.
-     */
-    DGMSolo12();
-
-    /**
-     * @brief ~DemoSingleMotor is the destructor.
-     */
-    ~DGMSolo12();
-
-    /**
-     * @brief This function make also sure that the joint velocity do not exceed
-     * a certain value
-     */
-    bool is_in_safety_mode();
-
-    /**
-     * @brief initialize_hardware_communication_process is the function that
-     * initialize the hardware.
-     */
-    void initialize_hardware_communication_process();
-
-    /**
-     * @brief get_sensors_to_map acquieres the sensors data and feed it to the
-     * input/output map
-     * @param[in][out] map is the sensors data filled by this function.
-     */
-    void get_sensors_to_map(dynamic_graph_manager::VectorDGMap& map);
-
-    /**
-     * @brief set_motor_controls_from_map reads the input map that contains the
-     * controls and send these controls to the hardware.
-     * @param map
-     */
-    void set_motor_controls_from_map(
-        const dynamic_graph_manager::VectorDGMap& map);
-
-    /**
-     * @brief Ros callback for the callibration procedure. Warning the robot
-     * will move to the next the joint index and back to "0" upon this call.
-     * Be sure that no controller are running in parallel.
-     *
-     * @param req nothing
-     * @param res True if everything went well.
-     * @return true if everything went well.
-     * @return false if something went wrong.
-     */
-    void calibrate_joint_position_callback(
-        mim_msgs::srv::JointCalibration::Request::SharedPtr req,
-        mim_msgs::srv::JointCalibration::Response::SharedPtr res);
-
-    /**
-     * @brief compute_safety_controls computes safety controls very fast in case
-     * the dynamic graph is taking to much computation time or has crashed.
-     */
-    void compute_safety_controls();
-
-private:
-    /**
-     * @brief Calibrate the robot joint position
-     *
-     * @param zero_to_index_angle is the angle between the theoretical zero and
-     * the next positive angle.
-     */
-    void calibrate_joint_position(
-        const solo::Vector12d& zero_to_index_angle);
-
-    /**
-     * Entries for the real hardware.
-     */
-
-    /**
-     * @brief solo_ is the hardware drivers.
-     */
-    solo::Solo12 solo_;
-
-    /**
-     * @brief ctrl_joint_torques_ the joint torques to be sent. Used in this
-     * class to perform a local copy of the control. This is need in order
-     * to send this copy to the solo::Solo class
-     */
-    solo::Vector12d ctrl_joint_torques_;
+    static constexpr const char* name = "DGMSolo12";
+    static constexpr int joint_count = Solo12::joint_count;
+    static constexpr int motor_board_count = Solo12::motor_board_count;
+    static constexpr bool reads_network_id = true;
+    static constexpr bool reads_serial_port = true;
+    static constexpr bool has_safety_controls = true;
+
+    static constexpr int extra_sensor_count = 5;
+    static constexpr std::array<const char*, extra_sensor_count>
+        extra_sensor_names = {{"imu_accelerometer",
+                               "imu_gyroscope",
+                               "imu_attitude",
+                               "imu_linear_acceleration",
+                               "imu_attitude_quaternion"}};
+
+    static void initialize(Solo12& robot,
+                           const std::string& network_id,
+                           const std::string& serial_port)
+    {
+        robot.initialize(network_id, serial_port);
+    }
+
+    static void request_calibration(Solo12& robot,
+                                    const Solo12::JointVector& home_offset_rad)
+    {
+        robot.request_calibration(home_offset_rad);
+    }
+
+    static void enable_calibration_cache(Solo12& robot)
+    {
+        robot.enable_calibration_cache();
+    }
+
+    static bool has_error(const Solo12& robot)
+    {
+        return robot.has_error();
+    }
+
+    static void write_extra_sensors(
+        Solo12& robot, const DGMapHandles<extra_sensor_count>& handles)
+    {
+        handles[0] = robot.get_imu_accelerometer();
+        handles[1] = robot.get_imu_gyroscope();
+        handles[2] = robot.get_imu_attitude();
+        handles[3] = robot.get_imu_linear_acceleration();
+        handles[4] = robot.get_imu_attitude_quaternion();
+    }
+};
 
-    /**
-     * @brief Check if we entered once in the safety mode and stay there if so
-     */
-    bool was_in_safety_mode_;
+typedef DGMSoloAdapter<Solo12> DGMSolo12;
 
-    /**
-     * @brief These are the calibration value extracted from the paramters.
-     * They represent the distance between the theorical zero joint angle and
-     * the next jont index.
-     */
-    solo::Vector12d zero_to_index_angle_from_file_;
-};
+// Compiled once in dg_main_solo12.
+extern template class DGMSoloAdapter<Solo12>;
 
 }  // namespace solo
-
-#endif  // DGM_TEST_BENCH_8_MOTORS_HH
@@ -9,107 +9,66 @@
  * Gesellshaft.
  */
 
-#ifndef DGM_SOLO_HH
-#define DGM_SOLO_HH
+#pragma once
 
+#include "solo/dynamic_graph_manager/dgm_solo_adapter.hpp"
 #include "solo/solo8.hpp"
-#include "mim_msgs/srv/joint_calibration.hpp"
-#include "dynamic_graph_manager/dynamic_graph_manager.hpp"
-#include "yaml_utils/yaml_cpp_fwd.hpp"
 
 namespace solo
 {
-class DGMSolo8 : public dynamic_graph_manager::DynamicGraphManager
+/**
+ * @brief Solo8 part of the DGMSolo8: contact sensors of the slider box.
+ *
+ * Solo8 keeps the safety mode and the safety controls of the
+ * DynamicGraphManager, as before the adapter.
+ */
+template <>
+struct DGMSoloTraits<Solo8>
 {
-public:
-    /**
-     * @brief DemoSingleMotor is the constructor.
-     */
-    DGMSolo8();
-
-    /**
-     * @brief ~DemoSingleMotor is the destructor.
-     */
-    ~DGMSolo8();
-
-    /**
-     * @brief This function make also sure that the joint velocity do not exceed
-     * a certain value
-     */
-    //    bool is_in_safety_mode();
-
-    /**
-     * @brief initialize_hardware_communication_process is the function that
-     * initialize the hardware.
-     */
-    void initialize_hardware_communication_process();
-
-    /**
-     * @brief get_sensors_to_map acquieres the sensors data and feed it to the
-     * input/output map
-     * @param[in][out] map is the sensors data filled by this function.
-     */
-    void get_sensors_to_map(dynamic_graph_manager::VectorDGMap& map);
-
-    /**
-     * @brief set_motor_controls_from_map reads the input map that contains the
-     * controls and send these controls to the hardware.
-     * @param map
-     */
-    void set_motor_controls_from_map(
-        const dynamic_graph_manager::VectorDGMap& map);
-
-    /**
-     * @brief
-     *
-     * @param req
-     * @param res
-     * @return true
-     * @return false
-     */
-    void calibrate_joint_position_callback(
-        mim_msgs::srv::JointCalibration::Request::SharedPtr req,
-        mim_msgs::srv::JointCalibration::Response::SharedPtr res);
-
-private:
-    /**
-     * @brief Calibrate the robot joint position
-     *
-     * @param zero_to_index_angle is the angle between the theoretical zero and
-     * the next positive angle.
-     */
-    void calibrate_joint_position(
-        const solo::Vector8d& zero_to_index_angle);
-
-    /**
-     * Entries for the real hardware.
-     */
-
-    /**
-     * @brief test_bench_ the real test bench hardware drivers.
-     */
-    solo::Solo8 solo_;
-
-    /**
-     * @brief ctrl_joint_torques_ the joint torques to be sent. Used in this
-     * class to perform a local copy of the control. This is need in order
-     * to send this copy to the solo::Solo class
-     */
-    solo::Vector8d ctrl_joint_torques_;
+    static constexpr const char* name = "DGMSolo8";
+    static constexpr int joint_count = Solo8::joint_count;
+    static constexpr int motor_board_count = Solo8::motor_board_count;
+    static constexpr bool reads_network_id = true;
+    static constexpr bool reads_serial_port = false;
+    static constexpr bool has_safety_controls = false;
+
+    static constexpr int extra_sensor_count = 1;
+    static constexpr std::array<const char*, extra_sensor_count>
+        extra_sensor_names = {{"contact_sensors"}};
+
+    static void initialize(Solo8& robot,
+                           const std::string& network_id,
+                           const std::string&)
+    {
+        robot.initialize(network_id);
+    }
+
+    static void request_calibration(Solo8& robot,
+                                    const Solo8::JointVector& home_offset_rad)
+    {
+        robot.request_calibration(home_offset_rad);
+    }
+
+    static void enable_calibration_cache(Solo8& robot)
+    {
+        robot.enable_calibration_cache();
+    }
+
+    static bool has_error(const Solo8& robot)
+    {
+        return robot.has_error();
+    }
+
+    static void write_extra_sensors(
+        Solo8& robot, const DGMapHandles<extra_sensor_count>& handles)
+    {
+        handles[0] = robot.get_contact_sensors_states();
+    }
+};
 
-    /**
-     * @brief Check if we entered once in the safety mode and stay there if so
-     */
-    bool was_in_safety_mode_;
+typedef DGMSoloAdapter<Solo8> DGMSolo8;
 
-    /**
-     * @brief These are the calibration value extracted from the paramters.
-     * They represent the distance between the theorical zero joint angle and
-     * the next jont index.
-     */
-    solo::Vector8d zero_to_index_angle_from_file_;
-};
+// Compiled once in dg_main_solo8.
+extern template class DGMSoloAdapter<Solo8>;
 
 }  // namespace solo
-
-#endif  // DGM_TEST_BENCH_8_MOTORS_HH
@@ -11,95 +11,66 @@
 
 #pragma once
 
+#include "solo/dynamic_graph_manager/dgm_solo_adapter.hpp"
 #include "solo/solo8ti.hpp"
-#include "mim_msgs/srv/joint_calibration.hpp"
-#include "dynamic_graph_manager/dynamic_graph_manager.hpp"
-#include "yaml_utils/yaml_cpp_fwd.hpp"
 
 namespace solo
 {
-class DGMSolo8TI : public dynamic_graph_manager::DynamicGraphManager
+/**
+ * @brief Solo8TI part of the DGMSolo8TI: contact sensors of the slider box,
+ * CAN drivers configured at construction.
+ *
+ * The CAN motor boards do not report errors, so Solo8TI keeps the safety
+ * mode and the safety controls of the DynamicGraphManager.
+ */
+template <>
+struct DGMSoloTraits<Solo8TI>
 {
-public:
-    /**
-     * @brief DemoSingleMotor is the constructor.
-     */
-    DGMSolo8TI();
-
-    /**
-     * @brief ~DemoSingleMotor is the destructor.
-     */
-    ~DGMSolo8TI();
-
-    /**
-     * @brief initialize_hardware_communication_process is the function that
-     * initialize the hardware.
-     */
-    void initialize_hardware_communication_process();
+    static constexpr const char* name = "DGMSolo8TI";
+    static constexpr int joint_count = 8;
+    static constexpr int motor_board_count = 4;
+    static constexpr bool reads_network_id = false;
+    static constexpr bool reads_serial_port = false;
+    static constexpr bool has_safety_controls = false;
 
-    /**
-     * @brief get_sensors_to_map acquieres the sensors data and feed it to the
-     * input/output map
-     * @param[in][out] map is the sensors data filled by this function.
-     */
-    void get_sensors_to_map(dynamic_graph_manager::VectorDGMap& map);
+    static constexpr int extra_sensor_count = 1;
+    static constexpr std::array<const char*, extra_sensor_count>
+        extra_sensor_names = {{"contact_sensors"}};
 
-    /**
-     * @brief set_motor_controls_from_map reads the input map that contains the
-     * controls and send these controls to the hardware.
-     * @param map
-     */
-    void set_motor_controls_from_map(
-        const dynamic_graph_manager::VectorDGMap& map);
+    static void initialize(Solo8TI& robot,
+                           const std::string&,
+                           const std::string&)
+    {
+        robot.initialize();
+    }
 
-    /**
-     * @brief Handle the calibrate_joint callback.
-     *
-     * @param req ROS request.
-     * @param res ROS response.
-     * @returns True if calibration was successful, false otherwise.
-     */
-    void calibrate_joint_position_callback(
-        mim_msgs::srv::JointCalibration::Request::SharedPtr req,
-        mim_msgs::srv::JointCalibration::Response::SharedPtr res);
+    static void request_calibration(Solo8TI& robot,
+                                    const Vector8d& home_offset_rad)
+    {
+        robot.request_calibration(home_offset_rad);
+    }
 
-private:
-    /**
-     * @brief Calibrate the robot joint position
-     *
-     * @param zero_to_index_angle is the angle between the theoretical zero and
-     * the next positive angle.
-     */
-    void calibrate_joint_position(
-        const solo::Vector8d& zero_to_index_angle);
+    /** @brief No calibration cache for the CAN drivers. */
+    static void enable_calibration_cache(Solo8TI&)
+    {
+    }
 
-    /**
-     * Entries for the real hardware.
-     */
+    /** @brief The CAN motor boards do not report errors. */
+    static bool has_error(const Solo8TI&)
+    {
+        return false;
+    }
 
-    /**
-     * @brief test_bench_ the real test bench hardware drivers.
-     */
-    solo::Solo8TI solo_;
-
-    /**
-     * @brief ctrl_joint_torques_ the joint torques to be sent. Used in this
-     * class to perform a local copy of the control. This is need in order
-     * to send this copy to the solo::Solo class
-     */
-    solo::Vector8d ctrl_joint_torques_;
+    static void write_extra_sensors(
+        Solo8TI& robot, const DGMapHandles<extra_sensor_count>& handles)
+    {
+        handles[0] = robot.get_contact_sensors_states();
+    }
+};
 
-    /**
-     * @brief Check if we entered once in the safety mode and stay there if so
-     */
-    bool was_in_safety_mode_;
+typedef DGMSoloAdapter<Solo8TI> DGMSolo8TI;
 
-    /**
-     * @brief These are the calibration value extracted from the paramters.
-     * They represent the distance between the theorical zero joint angle and
-     * the next jont index.
-     */
-    solo::Vector8d zero_to_index_angle_from_file_;
-};
+// Compiled once in dg_main_solo8ti.
+extern template class DGMSoloAdapter<Solo8TI>;
 
 }  // namespace solo
@@ -0,0 +1,430 @@
+/**
+ * @file dgm_solo_adapter.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Dynamic graph manager hardware process shared by all the solo
+ * robots.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include <Eigen/Eigen>
+
+#include "dynamic_graph_manager/dynamic_graph_manager.hpp"
+#include "dynamic_graph_manager/ros.hpp"
+#include "mim_msgs/srv/joint_calibration.hpp"
+#include "solo/dynamic_graph_manager/dgm_map_handles.hpp"
+#include "yaml_utils/yaml_cpp_fwd.hpp"
+
+namespace solo
+{
+/**
+ * @brief Robot specific part of the DGMSoloAdapter, specialized for each
+ * robot next to its DGMSolo typedef.
+ *
+ * A specialization provides:
+ * - `static constexpr const char* name`, used in the messages.
+ * - `static constexpr int joint_count` and `motor_board_count`.
+ * - `static constexpr bool reads_network_id` and `reads_serial_port`, if
+ *   these hardware_communication parameters are read from the yaml file.
+ * - `static constexpr bool has_safety_controls`, if the adapter latches the
+ *   safety mode and computes the safety controls, else the defaults of the
+ *   DynamicGraphManager are kept.
+ * - `static void initialize(Robot&, const std::string& network_id,
+ *   const std::string& serial_port)`.
+ * - `static void request_calibration(Robot&, const JointVector&)`.
+ * - `static void enable_calibration_cache(Robot&)`, to restore the last
+ *   calibration at the next request instead of searching the indexes.
+ * - `static bool has_error(const Robot&)`, if a motor board reports an error.
+ * - `static constexpr std::array<const char*, extra_sensor_count>
+ *   extra_sensor_names` and `static void write_extra_sensors(Robot&,
+ *   const DGMapHandles<extra_sensor_count>&)`, the sensors only this robot
+ *   has, e.g. the IMU.
+ *
+ * @tparam Robot The robot drivers, e.g. Solo12.
+ */
+template <class Robot>
+struct DGMSoloTraits;
+
+/**
+ * @brief Hardware process of the dynamic graph manager for a solo robot.
+ *
+ * Copies the sensors of the robot into the sensor map, sends the controls of
+ * the control map, handles the safety mode and the calibration service. The
+ * sizes are compile time constants of the DGMSoloTraits, so all the copies
+ * are fixed size and the hot path has no dynamic dispatch besides the calls
+ * of the dynamic graph manager itself.
+ *
+ * @tparam Robot The robot drivers, e.g. Solo12.
+ */
+template <class Robot>
+class DGMSoloAdapter : public dynamic_graph_manager::DynamicGraphManager
+{
+public:
+    typedef DGMSoloTraits<Robot> Traits;
+    static constexpr int joint_count = Traits::joint_count;
+    static constexpr int motor_board_count = Traits::motor_board_count;
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, joint_count, 1> JointVector;
+
+    /**
+     * @brief Construct the process, the drivers are initialized by
+     * initialize_hardware_communication_process().
+     */
+    DGMSoloAdapter()
+        : sensor_handles_({"joint_positions",
+                           "joint_velocities",
+                           "joint_torques",
+                           "joint_target_torques",
+                           "joint_encoder_index",
+                           "slider_positions",
+                           "motor_enabled",
+                           "motor_ready",
+                           "motor_board_enabled",
+                           "motor_board_errors"}),
+          extra_sensor_handles_(Traits::extra_sensor_names),
+          control_handles_({"ctrl_joint_torques"}),
+          safety_sensor_handles_({"joint_velocities"}),
+          safety_control_handles_({"ctrl_joint_torques"})
+    {
+        was_in_safety_mode_ = false;
+        error_message_counter_ = 0;
+        safety_message_counter_ = 0;
+        zero_to_index_angle_from_file_.setZero();
+    }
+
+    ~DGMSoloAdapter()
+    {
+    }
+
+    /**
+     * @brief Latch the safety mode if a motor board reports an error or if
+     * the dynamic graph manager requests it. Without has_safety_controls,
+     * the DynamicGraphManager decides.
+     */
+    bool is_in_safety_mode()
+    {
+        if (!Traits::has_safety_controls)
+        {
+            return DynamicGraphManager::is_in_safety_mode();
+        }
+
+        // Check if any card is in an error state.
+        if (Traits::has_error(robot_))
+        {
+            was_in_safety_mode_ = true;
+            if (error_message_counter_ % 2000 == 0)
+            {
+                printf("%s: Going into safe mode as motor card reports "
+                       "error.\n",
+                       Traits::name);
+            }
+            error_message_counter_++;
+        }
+
+        if (was_in_safety_mode_ || DynamicGraphManager::is_in_safety_mode())
+        {
+            was_in_safety_mode_ = true;
+            if (safety_message_counter_ % 2000 == 0)
+            {
+                printf("%s: is_in_safety_mode.\n", Traits::name);
+            }
+            safety_message_counter_++;
+        }
+        return was_in_safety_mode_;
+    }
+
+    /**
+     * @brief initialize_hardware_communication_process reads the parameters,
+     * creates the calibration service and initializes the drivers.
+     */
+    void initialize_hardware_communication_process()
+    {
+        /**
+         * Load the calibration parameters.
+         */
+        YAML::ReadParameter(params_["hardware_communication"]["calibration"],
+                            "index_to_zero_angle",
+                            zero_to_index_angle_from_file_);
+
+        // Get the hardware communication ros node handle.
+        dynamic_graph_manager::RosNodePtr ros_node_handle =
+            dynamic_graph_manager::get_ros_node(
+                dynamic_graph_manager::HWC_ROS_NODE_NAME);
+
+        /** Initialize the user commands. */
+        ros_user_commands_.push_back(
+            ros_node_handle->create_service<mim_msgs::srv::JointCalibration>(
+                "calibrate_joint_position",
+                std::bind(&DGMSoloAdapter::calibrate_joint_position_callback,
+                          this,
+                          std::placeholders::_1,
+                          std::placeholders::_2)));
+
+        std::string network_id;
+        if (Traits::reads_network_id)
+        {
+            YAML::ReadParameter(
+                params_["hardware_communication"], "network_id", network_id);
+        }
+
+        std::string serial_port;
+        if (Traits::reads_serial_port)
+        {
+            YAML::ReadParameter(
+                params_["hardware_communication"], "serial_port", serial_port);
+        }
+
+        initialize_drivers(network_id, serial_port);
+        Traits::enable_calibration_cache(robot_);
+    }
+
+    /**
+     * @brief initialize_drivers initializes only the drivers, without reading
+     * the parameters nor creating the ROS services. Called by
+     * initialize_hardware_communication_process(), and used alone by the
+     * benchmarks.
+     * @param network_id Interface for connection to hardware, or "fake".
+     * @param serial_port Serial port of the slider box.
+     */
+    void initialize_drivers(const std::string& network_id,
+                            const std::string& serial_port)
+    {
+        Traits::initialize(robot_, network_id, serial_port);
+    }
+
+    /**
+     * @brief get_sensors_to_map acquieres the sensors data and feed it to the
+     * input/output map
+     * @param[in][out] map is the sensors data filled by this function.
+     */
+    void get_sensors_to_map(dynamic_graph_manager::VectorDGMap& map)
+    {
+        robot_.acquire_sensors();
+
+        // Only looks the entries up at the first cycle.
+        sensor_handles_.resolve(map);
+        extra_sensor_handles_.resolve(map);
+
+        /**
+         * Joint data.
+         */
+        sensor_handles_[sensor_joint_positions] = robot_.get_joint_positions();
+        sensor_handles_[sensor_joint_velocities] =
+            robot_.get_joint_velocities();
+        sensor_handles_[sensor_joint_torques] = robot_.get_joint_torques();
+        sensor_handles_[sensor_joint_target_torques] =
+            robot_.get_joint_target_torques();
+        sensor_handles_[sensor_joint_encoder_index] =
+            robot_.get_joint_encoder_index();
+
+        /**
+         * Additional data.
+         */
+        sensor_handles_[sensor_slider_positions] =
+            robot_.get_slider_positions();
+        Traits::write_extra_sensors(robot_, extra_sensor_handles_);
+
+        /**
+         * Robot status.
+         */
+        dynamicgraph::Vector& map_motor_enabled =
+            sensor_handles_[sensor_motor_enabled];
+        dynamicgraph::Vector& map_motor_ready =
+            sensor_handles_[sensor_motor_ready];
+        dynamicgraph::Vector& map_motor_board_enabled =
+            sensor_handles_[sensor_motor_board_enabled];
+        dynamicgraph::Vector& map_motor_board_errors =
+            sensor_handles_[sensor_motor_board_errors];
+        const std::array<bool, joint_count>& motor_enabled =
+            robot_.get_motor_enabled();
+        const std::array<bool, joint_count>& motor_ready =
+            robot_.get_motor_ready();
+        const std::array<bool, motor_board_count>& motor_board_enabled =
+            robot_.get_motor_board_enabled();
+        const std::array<int, motor_board_count>& motor_board_errors =
+            robot_.get_motor_board_errors();
+
+        for (int i = 0; i < joint_count; ++i)
+        {
+            map_motor_enabled[i] = motor_enabled[i];
+            map_motor_ready[i] = motor_ready[i];
+        }
+        for (int i = 0; i < motor_board_count; ++i)
+        {
+            map_motor_board_enabled[i] = motor_board_enabled[i];
+            map_motor_board_errors[i] = motor_board_errors[i];
+        }
+    }
+
+    /**
+     * @brief set_motor_controls_from_map reads the input map that contains the
+     * controls and send these controls to the hardware.
+     * @param map
+     */
+    void set_motor_controls_from_map(
+        const dynamic_graph_manager::VectorDGMap& map)
+    {
+        try
+        {
+            // Only looks the entry up at the first cycle.
+            control_handles_.resolve(map);
+            // Actually send the control to the robot, straight from the map.
+            robot_.send_target_joint_torque(
+                control_handles_[control_joint_torques]);
+        }
+        catch (const std::exception& e)
+        {
+            rt_printf(
+                "%s::set_motor_controls_from_map: "
+                "Error sending controls, %s\n",
+                Traits::name,
+                e.what());
+        }
+    }
+
+    /**
+     * @brief Ros callback for the callibration procedure. Warning the robot
+     * will move to the next the joint index and back to "0" upon this call.
+     * Be sure that no controller are running in parallel.
+     *
+     * @param req nothing
+     * @param res True if everything went well.
+     */
+    void calibrate_joint_position_callback(
+        mim_msgs::srv::JointCalibration::Request::SharedPtr,
+        mim_msgs::srv::JointCalibration::Response::SharedPtr res)
+    {
+        // Parse and register the command for further call.
+        add_user_command(std::bind(&DGMSoloAdapter::calibrate_joint_position,
+                                   this,
+                                   zero_to_index_angle_from_file_));
+
+        // Return a sanity check that assert that the function has been
+        // correctly registered in the hardware process.
+        res->sanity_check = true;
+    }
+
+    /**
+     * @brief compute_safety_controls computes safety controls very fast in case
+     * the dynamic graph is taking to much computation time or has crashed.
+     * Without has_safety_controls, the DynamicGraphManager computes them.
+     */
+    void compute_safety_controls()
+    {
+        if (!Traits::has_safety_controls)
+        {
+            DynamicGraphManager::compute_safety_controls();
+            return;
+        }
+
+        // Check if there is an error with the motors. If so, best we can do is
+        // to command zero torques.
+        if (Traits::has_error(robot_))
+        {
+            for (auto ctrl = motor_controls_map_.begin();
+                 ctrl != motor_controls_map_.end();
+                 ++ctrl)
+            {
+                ctrl->second.fill(0.0);
+            }
+        }
+        else
+        {
+            // The motors are fine.
+            // --> Run a D controller to damp the current motion.
+            safety_sensor_handles_.resolve(sensors_map_);
+            safety_control_handles_.resolve(motor_controls_map_);
+            safety_control_handles_[0] =
+                -safety_damping * safety_sensor_handles_[0];
+        }
+    }
+
+private:
+    /** @brief Damping gain of the safety controls (Nm s/rad). */
+    static constexpr double safety_damping = 0.05;
+
+    /** @brief Entries of the sensor map common to all the robots. */
+    enum SensorEntry
+    {
+        sensor_joint_positions,
+        sensor_joint_velocities,
+        sensor_joint_torques,
+        sensor_joint_target_torques,
+        sensor_joint_encoder_index,
+        sensor_slider_positions,
+        sensor_motor_enabled,
+        sensor_motor_ready,
+        sensor_motor_board_enabled,
+        sensor_motor_board_errors,
+        sensor_entry_count
+    };
+
+    /** @brief Entries of the control map. */
+    enum ControlEntry
+    {
+        control_joint_torques,
+        control_entry_count
+    };
+
+    /**
+     * @brief Calibrate the robot joint position
+     *
+     * @param zero_to_index_angle is the angle between the theoretical zero and
+     * the next positive angle.
+     */
+    void calibrate_joint_position(const JointVector& zero_to_index_angle)
+    {
+        Traits::request_calibration(robot_, zero_to_index_angle);
+    }
+
+    /**
+     * @brief robot_ is the hardware drivers.
+     */
+    Robot robot_;
+
+    /** @brief Sensor map entries, resolved at the first cycle. */
+    DGMapHandles<sensor_entry_count> sensor_handles_;
+
+    /** @brief Sensor map entries of this robot only. */
+    DGMapHandles<Traits::extra_sensor_count> extra_sensor_handles_;
+
+    /** @brief Control map entries, resolved at the first cycle. */
+    DGMapHandles<control_entry_count, const dynamic_graph_manager::VectorDGMap>
+        control_handles_;
+
+    /** @brief Joint velocities read by compute_safety_controls(). */
+    DGMapHandles<1, const dynamic_graph_manager::VectorDGMap>
+        safety_sensor_handles_;
+
+    /** @brief Joint torques written by compute_safety_controls(). */
+    DGMapHandles<1> safety_control_handles_;
+
+    /**
+     * @brief Check if we entered once in the safety mode and stay there if so
+     */
+    bool was_in_safety_mode_;
+
+    /** @brief Throttles the motor board error message. */
+    int error_message_counter_;
+
+    /** @brief Throttles the safety mode message. */
+    int safety_message_counter_;
+
+    /**
+     * @brief These are the calibration value extracted from the paramters.
+     * They represent the distance between the theorical zero joint angle and
+     * the next jont index.
+     */
+    JointVector zero_to_index_angle_from_file_;
+};
+
+}  // namespace solo
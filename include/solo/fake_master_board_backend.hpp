@@ -0,0 +1,558 @@
+/**
+ * @file fake_master_board_backend.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief In-process emulation of a master board and its motors.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "solo/master_board_backend.hpp"
+
+namespace solo
+{
+/**
+ * @brief Tuning of the emulated master board.
+ */
+struct FakeMasterBoardParameters
+{
+    FakeMasterBoardParameters()
+    {
+        time_step = 0.001;
+        ack_delay = 5;
+        enable_delay = 10;
+        ready_delay = 200;
+        joint_inertia = 0.005;
+        joint_damping = 0.02;
+        motor_index_phase = 1.0;
+    }
+
+    /** @brief Simulated time between two send_command() (s). */
+    double time_step;
+    /** @brief Number of init packets before the acknowledgement. */
+    int ack_delay;
+    /** @brief Number of commands after the acknowledgement before the motor
+     * boards and the motors are enabled. */
+    int enable_delay;
+    /** @brief Number of commands after the enabling before the motors are
+     * aligned and ready. */
+    int ready_delay;
+    /** @brief Joint inertia seen after the gear box (kg m^2). */
+    double joint_inertia;
+    /** @brief Viscous friction of the joints (Nm s/rad). */
+    double joint_damping;
+    /** @brief Motor angle of the encoder index, repeated every motor turn
+     * (rad). */
+    double motor_index_phase;
+};
+
+/**
+ * @brief Master board backend emulated in the process, to run the robot
+ * classes, the demos and the benchmarks without hardware.
+ *
+ * It reproduces the sequence the robot classes rely on:
+ * - the acknowledgement arrives after a few init packets,
+ * - the motor boards and motors get enabled, then ready after an alignment
+ *   delay,
+ * - the encoder index is detected when the motor shaft crosses it, the
+ *   joint positions are then relative to the index and the calibration
+ *   offsets,
+ * - the joints are rigid bodies driven by the current limited torques with
+ *   viscous friction, the velocity and position limits trigger the safety
+ *   damping like on the real robot.
+ *
+ * Simulated time only advances in send_command(), so a control loop runs as
+ * fast as it computes and the results are deterministic.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+class FakeMasterBoardBackend
+    : public MasterBoardBackend<JOINT_COUNT, MOTOR_BOARD_COUNT>
+{
+public:
+    typedef typename MasterBoardBackend<JOINT_COUNT,
+                                        MOTOR_BOARD_COUNT>::JointVector
+        JointVector;
+
+    /**
+     * @brief Construct a powered off master board.
+     *
+     * @param config Description of the emulated robot.
+     * @param parameters Tuning of the emulation.
+     */
+    FakeMasterBoardBackend(
+        const MasterBoardBackendConfig<JOINT_COUNT>& config,
+        const FakeMasterBoardParameters& parameters =
+            FakeMasterBoardParameters())
+        : config_(config), parameters_(parameters)
+    {
+        max_current_ = config_.motor_max_current;
+        torque_per_current_ =
+            config_.motor_torque_constant * config_.joint_gear_ratio;
+        calibration_offsets_.setZero();
+        imu_accelerometer_ << 0.0, 0.0, 9.81;
+        imu_gyroscope_.setZero();
+        imu_attitude_.setZero();
+        imu_linear_acceleration_.setZero();
+        imu_attitude_quaternion_ << 0.0, 0.0, 0.0, 1.0;
+        motor_board_errors_.fill(0);
+        reset();
+    }
+
+    void init()
+    {
+        reset();
+        initialized_ = true;
+    }
+
+    void send_init()
+    {
+        if (initialized_ && ++init_packet_count_ >= parameters_.ack_delay)
+        {
+            ack_received_ = true;
+        }
+    }
+
+    void send_command()
+    {
+        if (!ack_received_)
+        {
+            return;
+        }
+        ++command_count_;
+        const bool enabled = command_count_ >= parameters_.enable_delay;
+        const bool ready = command_count_ >= parameters_.enable_delay +
+                                                 parameters_.ready_delay;
+        motor_board_enabled_.fill(enabled);
+        motor_enabled_.fill(enabled);
+        motor_ready_.fill(ready);
+        step();
+    }
+
+    void parse_sensor_data()
+    {
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            joint_positions_(i) = measured_position(i);
+        }
+        joint_velocities_ = velocities_;
+        joint_measured_torques_ = applied_torques_;
+        joint_sent_torques_ = applied_torques_;
+    }
+
+    bool is_ack_msg_received()
+    {
+        return ack_received_;
+    }
+
+    bool is_timeout()
+    {
+        return false;
+    }
+
+    bool is_ready()
+    {
+        return ack_received_ && motor_ready_[0];
+    }
+
+    bool has_error()
+    {
+        return has_error_;
+    }
+
+    void report_error(const char* message)
+    {
+        std::fprintf(stderr, "FakeMasterBoardBackend: ERROR: %s\n", message);
+        has_error_ = true;
+    }
+
+    void set_torques(const JointVector& torques)
+    {
+        command_torques_ = torques;
+    }
+
+    void set_zero_commands()
+    {
+        command_torques_.setZero();
+    }
+
+    void set_maximum_current(double max_current)
+    {
+        max_current_ = max_current;
+    }
+
+    void set_calibration_offsets(const JointVector& position_offsets)
+    {
+        calibration_offsets_ = position_offsets;
+        calibration_time_ = 0.0;
+        calibration_searching_ = true;
+    }
+
+    /**
+     * @brief Same two steps as the odri JointCalibrator: move each joint in
+     * its search direction until the index is found, then go to the zero
+     * position with a smooth interpolation.
+     */
+    bool run_calibration()
+    {
+        const double dt = config_.calibration_dt;
+        const double duration = config_.calibration_duration;
+        if (calibration_searching_)
+        {
+            if (calibration_time_ == 0.0)
+            {
+                index_detected_.fill(false);
+                calibration_start_ = positions_;
+            }
+            bool all_detected = true;
+            for (int i = 0; i < JOINT_COUNT; ++i)
+            {
+                // One motor turn per calibration duration.
+                const double search_velocity =
+                    search_direction(i) * 2.0 * M_PI /
+                    (config_.joint_gear_ratio * duration);
+                const double target =
+                    calibration_start_(i) + search_velocity * calibration_time_;
+                // Hold the joints that already found their index.
+                command_torques_(i) =
+                    index_detected_[i]
+                        ? config_.calibration_kp *
+                                  (index_positions_(i) - positions_(i)) -
+                              config_.calibration_kd * velocities_(i)
+                        : config_.calibration_kp * (target - positions_(i)) +
+                              config_.calibration_kd *
+                                  (search_velocity - velocities_(i));
+                all_detected &= index_detected_[i];
+            }
+            calibration_time_ += dt;
+            if (all_detected)
+            {
+                calibration_searching_ = false;
+                calibration_time_ = 0.0;
+                for (int i = 0; i < JOINT_COUNT; ++i)
+                {
+                    calibration_start_(i) = measured_position(i);
+                }
+            }
+            return false;
+        }
+
+        const double alpha = std::min(calibration_time_ / duration, 1.0);
+        const double blend = 0.5 * (1.0 - std::cos(M_PI * alpha));
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            const double target = (1.0 - blend) * calibration_start_(i);
+            command_torques_(i) =
+                config_.calibration_kp * (target - measured_position(i)) -
+                config_.calibration_kd * velocities_(i);
+        }
+        calibration_time_ += dt;
+        if (alpha >= 1.0)
+        {
+            command_torques_.setZero();
+            calibration_searching_ = true;
+            calibration_time_ = 0.0;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Like the motor boards, the emulation keeps the indexes crossed
+     * since init().
+     */
+    bool restore_calibration(const JointVector& position_offsets)
+    {
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            if (!index_detected_[i])
+            {
+                return false;
+            }
+        }
+        calibration_offsets_ = position_offsets;
+        return true;
+    }
+
+    const JointVector& get_joint_positions() const
+    {
+        return joint_positions_;
+    }
+    const JointVector& get_joint_velocities() const
+    {
+        return joint_velocities_;
+    }
+    const JointVector& get_joint_measured_torques() const
+    {
+        return joint_measured_torques_;
+    }
+    const JointVector& get_joint_sent_torques() const
+    {
+        return joint_sent_torques_;
+    }
+    const Eigen::Vector3d& get_imu_accelerometer() const
+    {
+        return imu_accelerometer_;
+    }
+    const Eigen::Vector3d& get_imu_gyroscope() const
+    {
+        return imu_gyroscope_;
+    }
+    const Eigen::Vector3d& get_imu_attitude() const
+    {
+        return imu_attitude_;
+    }
+    const Eigen::Vector3d& get_imu_linear_acceleration() const
+    {
+        return imu_linear_acceleration_;
+    }
+    const Eigen::Vector4d& get_imu_attitude_quaternion() const
+    {
+        return imu_attitude_quaternion_;
+    }
+    const std::array<bool, JOINT_COUNT>& get_motor_enabled() const
+    {
+        return motor_enabled_;
+    }
+    const std::array<bool, JOINT_COUNT>& get_motor_ready() const
+    {
+        return motor_ready_;
+    }
+    const std::array<bool, MOTOR_BOARD_COUNT>& get_motor_board_enabled() const
+    {
+        return motor_board_enabled_;
+    }
+    const std::array<int, MOTOR_BOARD_COUNT>& get_motor_board_errors() const
+    {
+        return motor_board_errors_;
+    }
+
+    /**
+     * @brief Get the simulated joint positions, independent of the encoder
+     * index and calibration (rad).
+     */
+    const JointVector& get_true_joint_positions() const
+    {
+        return positions_;
+    }
+
+private:
+    /**
+     * @brief Power cycle: the joints rest at zero and no index is known.
+     */
+    void reset()
+    {
+        initialized_ = false;
+        ack_received_ = false;
+        has_error_ = false;
+        init_packet_count_ = 0;
+        command_count_ = 0;
+        calibration_searching_ = true;
+        calibration_time_ = 0.0;
+        calibration_start_.setZero();
+        positions_.setZero();
+        velocities_.setZero();
+        command_torques_.setZero();
+        applied_torques_.setZero();
+        index_positions_.setZero();
+        index_detected_.fill(false);
+        joint_positions_.setZero();
+        joint_velocities_.setZero();
+        joint_measured_torques_.setZero();
+        joint_sent_torques_.setZero();
+        motor_enabled_.fill(false);
+        motor_ready_.fill(false);
+        motor_board_enabled_.fill(false);
+    }
+
+    /**
+     * @brief Integrate the joint dynamics over one time step.
+     */
+    void step()
+    {
+        const double dt = parameters_.time_step;
+        const double max_torque = max_current_ * torque_per_current_;
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            double torque = 0.0;
+            if (has_error_)
+            {
+                torque = -config_.safety_damping * velocities_(i);
+            }
+            else if (motor_enabled_[i])
+            {
+                torque = std::max(-max_torque,
+                                  std::min(max_torque, command_torques_(i)));
+            }
+            applied_torques_(i) = torque;
+
+            const double acceleration =
+                (torque - parameters_.joint_damping * velocities_(i)) /
+                parameters_.joint_inertia;
+            velocities_(i) += acceleration * dt;
+            const double previous_position = positions_(i);
+            positions_(i) += velocities_(i) * dt;
+            detect_index(i, previous_position, positions_(i));
+        }
+        check_limits();
+    }
+
+    /**
+     * @brief Latch the joint position of the first encoder index crossed.
+     */
+    void detect_index(int i, double previous_position, double position)
+    {
+        if (index_detected_[i])
+        {
+            return;
+        }
+        const double gear_ratio = config_.joint_gear_ratio;
+        const double turn = 2.0 * M_PI;
+        const double previous_turn = std::floor(
+            (gear_ratio * previous_position - parameters_.motor_index_phase) /
+            turn);
+        const double current_turn = std::floor(
+            (gear_ratio * position - parameters_.motor_index_phase) / turn);
+        if (previous_turn != current_turn)
+        {
+            const double crossed_turn = std::max(previous_turn, current_turn);
+            index_positions_(i) =
+                (crossed_turn * turn + parameters_.motor_index_phase) /
+                gear_ratio;
+            index_detected_[i] = true;
+        }
+    }
+
+    /**
+     * @brief Report an error on excessive velocities or, once the index is
+     * known, on positions outside the joint limits.
+     */
+    void check_limits()
+    {
+        if (has_error_)
+        {
+            return;
+        }
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            if (std::abs(velocities_(i)) > config_.max_joint_velocity)
+            {
+                report_error("Joint velocity limit exceeded.");
+                return;
+            }
+            const double position = measured_position(i);
+            if (index_detected_[i] && !calibration_searching_ &&
+                (position < config_.joint_lower_limits(i) ||
+                 position > config_.joint_upper_limits(i)))
+            {
+                report_error("Joint position limit exceeded.");
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Position reported by the encoder: relative to power on until
+     * the index is detected, then relative to the index and calibration
+     * offset.
+     */
+    double measured_position(int i) const
+    {
+        if (!index_detected_[i])
+        {
+            return positions_(i);
+        }
+        return positions_(i) - index_positions_(i) - calibration_offsets_(i);
+    }
+
+    /**
+     * @brief +1 or -1, direction of the index search of a joint.
+     */
+    double search_direction(int i) const
+    {
+        return config_.calibration_directions[i] ==
+                       odri_control_interface::NEGATIVE
+                   ? -1.0
+                   : 1.0;
+    }
+
+    /** @brief Description of the emulated robot. */
+    MasterBoardBackendConfig<JOINT_COUNT> config_;
+    /** @brief Tuning of the emulation. */
+    FakeMasterBoardParameters parameters_;
+    /** @brief Current limit (A). */
+    double max_current_;
+    /** @brief Joint torque per motor current (Nm/A). */
+    double torque_per_current_;
+
+    /** @brief If init() was called. */
+    bool initialized_;
+    /** @brief If the init packet was acknowledged. */
+    bool ack_received_;
+    /** @brief If an error is latched. */
+    bool has_error_;
+    /** @brief Number of init packets received. */
+    int init_packet_count_;
+    /** @brief Number of commands received since the acknowledgement. */
+    long command_count_;
+
+    /** @brief If the calibration is searching the indexes. */
+    bool calibration_searching_;
+    /** @brief Time spent in the current calibration step (s). */
+    double calibration_time_;
+    /** @brief Positions at the start of the current calibration step. */
+    JointVector calibration_start_;
+    /** @brief Joint positions at the indexes after calibration (rad). */
+    JointVector calibration_offsets_;
+
+    /** @brief Simulated joint positions (rad). */
+    JointVector positions_;
+    /** @brief Simulated joint velocities (rad/s). */
+    JointVector velocities_;
+    /** @brief Torques of the last commands (Nm). */
+    JointVector command_torques_;
+    /** @brief Torques applied during the last time step (Nm). */
+    JointVector applied_torques_;
+    /** @brief Simulated joint positions of the detected indexes (rad). */
+    JointVector index_positions_;
+    /** @brief If the index of each joint was detected. */
+    std::array<bool, JOINT_COUNT> index_detected_;
+
+    /** @brief Joint positions (rad). */
+    JointVector joint_positions_;
+    /** @brief Joint velocities (rad/s). */
+    JointVector joint_velocities_;
+    /** @brief Measured joint torques (Nm). */
+    JointVector joint_measured_torques_;
+    /** @brief Joint torques sent to the motors (Nm). */
+    JointVector joint_sent_torques_;
+    /** @brief Base accelerometer. */
+    Eigen::Vector3d imu_accelerometer_;
+    /** @brief Base gyroscope. */
+    Eigen::Vector3d imu_gyroscope_;
+    /** @brief Base attitude (euler angles). */
+    Eigen::Vector3d imu_attitude_;
+    /** @brief Base linear acceleration. */
+    Eigen::Vector3d imu_linear_acceleration_;
+    /** @brief Base attitude quaternion ordered {x, y, z, w}. */
+    Eigen::Vector4d imu_attitude_quaternion_;
+    /** @brief Enabled status of each motor. */
+    std::array<bool, JOINT_COUNT> motor_enabled_;
+    /** @brief Ready status of each motor. */
+    std::array<bool, JOINT_COUNT> motor_ready_;
+    /** @brief Enabled status of each motor board. */
+    std::array<bool, MOTOR_BOARD_COUNT> motor_board_enabled_;
+    /** @brief Error code of each motor board. */
+    std::array<int, MOTOR_BOARD_COUNT> motor_board_errors_;
+};
+
+}  // namespace solo
@@ -0,0 +1,440 @@
+/**
+ * @file filters.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Fixed size filters for the sliders and the sensor signals.
+ *
+ * Every filter works on a whole Eigen vector of channels at once, keeps its
+ * state in fixed size members and never allocates, so that it can be used
+ * inside the real time control loop.
+ */
+
+#pragma once
+
+#include <Eigen/Eigen>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace solo
+{
+/**
+ * @brief Moving average over the last WINDOW_SIZE samples.
+ *
+ * The sum of the window is updated with the incoming and outgoing samples so
+ * that each sample costs O(1). A second sum only adds the samples since the
+ * window last wrapped around: when it wraps again, this sum covers exactly
+ * the window and replaces the running one, cancelling the rounding error
+ * accumulated by the subtractions without ever summing the whole window.
+ * Until the window is full the mean of the samples received so far is
+ * returned.
+ *
+ * @tparam CHANNELS Number of filtered signals.
+ * @tparam WINDOW_SIZE Number of averaged samples.
+ */
+template <int CHANNELS, int WINDOW_SIZE>
+class RunningMeanFilter
+{
+    static_assert(WINDOW_SIZE > 0, "The window must hold a sample.");
+
+public:
+    /** @brief Vector of the filtered signals. */
+    typedef Eigen::Matrix<double, CHANNELS, 1> Vector;
+
+    RunningMeanFilter()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Forget all the samples.
+     */
+    void reset()
+    {
+        sum_.setZero();
+        pass_sum_.setZero();
+        output_.setZero();
+        size_ = 0;
+        index_ = 0;
+    }
+
+    /**
+     * @brief Add a sample and compute the new mean.
+     *
+     * @param input
+     * @return const Vector& The mean of the window.
+     */
+    const Vector& filter(const Vector& input)
+    {
+        if (size_ < WINDOW_SIZE)
+        {
+            ++size_;
+        }
+        else
+        {
+            sum_ -= window_[index_];
+        }
+        window_[index_] = input;
+        sum_ += input;
+        pass_sum_ += input;
+
+        if (++index_ == WINDOW_SIZE)
+        {
+            index_ = 0;
+            sum_ = pass_sum_;
+            pass_sum_.setZero();
+        }
+        output_ = sum_ / double(size_);
+        return output_;
+    }
+
+    /**
+     * @brief Get the output of the last call to filter().
+     */
+    const Vector& get_output() const
+    {
+        return output_;
+    }
+
+    /**
+     * @brief Number of samples in the window.
+     */
+    int size() const
+    {
+        return size_;
+    }
+
+private:
+    /** @brief Last WINDOW_SIZE samples. */
+    std::array<Vector, WINDOW_SIZE> window_;
+    /** @brief Sum of the samples in the window. */
+    Vector sum_;
+    /** @brief Sum of the samples since the window last wrapped around. */
+    Vector pass_sum_;
+    /** @brief Mean of the window. */
+    Vector output_;
+    /** @brief Number of samples in the window. */
+    int size_;
+    /** @brief Slot of the next sample. */
+    int index_;
+};
+
+/**
+ * @brief First order low pass filter, y += alpha * (x - y).
+ *
+ * The first sample initializes the output, so there is no transient from
+ * zero.
+ *
+ * @tparam CHANNELS Number of filtered signals.
+ */
+template <int CHANNELS>
+class FirstOrderLowPassFilter
+{
+public:
+    /** @brief Vector of the filtered signals. */
+    typedef Eigen::Matrix<double, CHANNELS, 1> Vector;
+
+    /**
+     * @brief Construct a new FirstOrderLowPassFilter from its smoothing
+     * factor.
+     *
+     * @param alpha Weight of the new sample in ]0, 1], 1 disables the
+     * filter.
+     */
+    FirstOrderLowPassFilter(double alpha = 1.0)
+    {
+        set_alpha(alpha);
+        reset();
+    }
+
+    /**
+     * @brief Construct a new FirstOrderLowPassFilter from its cutoff
+     * frequency.
+     *
+     * @param cutoff_frequency (Hz)
+     * @param sampling_period (s)
+     */
+    FirstOrderLowPassFilter(double cutoff_frequency, double sampling_period)
+    {
+        const double time_constant = 1.0 / (2.0 * M_PI * cutoff_frequency);
+        set_alpha(sampling_period / (time_constant + sampling_period));
+        reset();
+    }
+
+    /**
+     * @brief Set the weight of the new sample in ]0, 1].
+     */
+    void set_alpha(double alpha)
+    {
+        if (!(alpha > 0.0 && alpha <= 1.0))
+        {
+            throw std::runtime_error(
+                "FirstOrderLowPassFilter: alpha must be in ]0, 1].");
+        }
+        alpha_ = alpha;
+    }
+
+    /**
+     * @brief Restart from the next sample.
+     */
+    void reset()
+    {
+        output_.setZero();
+        initialized_ = false;
+    }
+
+    /**
+     * @brief Add a sample and compute the new output.
+     *
+     * @param input
+     * @return const Vector& The filtered signals.
+     */
+    const Vector& filter(const Vector& input)
+    {
+        if (initialized_)
+        {
+            output_ += alpha_ * (input - output_);
+        }
+        else
+        {
+            output_ = input;
+            initialized_ = true;
+        }
+        return output_;
+    }
+
+    /**
+     * @brief Get the output of the last call to filter().
+     */
+    const Vector& get_output() const
+    {
+        return output_;
+    }
+
+private:
+    /** @brief Weight of the new sample. */
+    double alpha_;
+    /** @brief Filtered signals. */
+    Vector output_;
+    /** @brief If a sample was received since the last reset. */
+    bool initialized_;
+};
+
+/**
+ * @brief Second order Butterworth low pass filter.
+ *
+ * Biquad discretized with the bilinear transform, in transposed direct form
+ * II. The state is initialized at steady state on the first sample, so
+ * there is no transient from zero.
+ *
+ * @tparam CHANNELS Number of filtered signals.
+ */
+template <int CHANNELS>
+class SecondOrderLowPassFilter
+{
+public:
+    /** @brief Vector of the filtered signals. */
+    typedef Eigen::Matrix<double, CHANNELS, 1> Vector;
+
+    /**
+     * @brief Construct a new SecondOrderLowPassFilter.
+     *
+     * @param cutoff_frequency (Hz), must be below the Nyquist frequency.
+     * @param sampling_period (s)
+     */
+    SecondOrderLowPassFilter(double cutoff_frequency, double sampling_period)
+    {
+        if (!(cutoff_frequency > 0.0 &&
+              cutoff_frequency * sampling_period < 0.5))
+        {
+            throw std::runtime_error(
+                "SecondOrderLowPassFilter: the cutoff frequency must be in "
+                "]0, 0.5 / sampling_period[.");
+        }
+        const double k = std::tan(M_PI * cutoff_frequency * sampling_period);
+        const double q = M_SQRT1_2;
+        const double norm = 1.0 / (1.0 + k / q + k * k);
+        b0_ = k * k * norm;
+        b1_ = 2.0 * b0_;
+        b2_ = b0_;
+        a1_ = 2.0 * (k * k - 1.0) * norm;
+        a2_ = (1.0 - k / q + k * k) * norm;
+        reset();
+    }
+
+    /**
+     * @brief Restart from the next sample.
+     */
+    void reset()
+    {
+        state_1_.setZero();
+        state_2_.setZero();
+        output_.setZero();
+        initialized_ = false;
+    }
+
+    /**
+     * @brief Add a sample and compute the new output.
+     *
+     * @param input
+     * @return const Vector& The filtered signals.
+     */
+    const Vector& filter(const Vector& input)
+    {
+        if (!initialized_)
+        {
+            // Steady state for a constant input, the DC gain is 1.
+            state_1_ = (1.0 - b0_) * input;
+            state_2_ = (b2_ - a2_) * input;
+            initialized_ = true;
+        }
+        output_ = b0_ * input + state_1_;
+        state_1_ = b1_ * input - a1_ * output_ + state_2_;
+        state_2_ = b2_ * input - a2_ * output_;
+        return output_;
+    }
+
+    /**
+     * @brief Get the output of the last call to filter().
+     */
+    const Vector& get_output() const
+    {
+        return output_;
+    }
+
+private:
+    /** @brief Feedforward coefficients. */
+    double b0_, b1_, b2_;
+    /** @brief Feedback coefficients, a0 is normalized to 1. */
+    double a1_, a2_;
+    /** @brief Delayed states. */
+    Vector state_1_, state_2_;
+    /** @brief Filtered signals. */
+    Vector output_;
+    /** @brief If a sample was received since the last reset. */
+    bool initialized_;
+};
+
+/**
+ * @brief Median of the last WINDOW_SIZE samples, to reject outliers.
+ *
+ * Each channel keeps its window sorted: a sample replaces the oldest one by
+ * shifting at most WINDOW_SIZE values, so the cost is bounded by the small
+ * compile time window instead of a sort. Until the window is full the median
+ * of the samples received so far is returned.
+ *
+ * @tparam CHANNELS Number of filtered signals.
+ * @tparam WINDOW_SIZE Number of samples, usually small and odd.
+ */
+template <int CHANNELS, int WINDOW_SIZE>
+class MedianFilter
+{
+    static_assert(WINDOW_SIZE > 0, "The window must hold a sample.");
+
+public:
+    /** @brief Vector of the filtered signals. */
+    typedef Eigen::Matrix<double, CHANNELS, 1> Vector;
+
+    MedianFilter()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Forget all the samples.
+     */
+    void reset()
+    {
+        output_.setZero();
+        size_ = 0;
+        index_ = 0;
+    }
+
+    /**
+     * @brief Add a sample and compute the new median.
+     *
+     * @param input
+     * @return const Vector& The median of the window.
+     */
+    const Vector& filter(const Vector& input)
+    {
+        for (int channel = 0; channel < CHANNELS; ++channel)
+        {
+            const double value = input(channel);
+            double* sorted = sorted_[channel].data();
+            int position;
+            if (size_ < WINDOW_SIZE)
+            {
+                position = size_;
+            }
+            else
+            {
+                // Find the oldest sample, it is replaced by the new one.
+                position = int(std::lower_bound(sorted,
+                                                sorted + size_,
+                                                history_[channel][index_]) -
+                               sorted);
+            }
+            history_[channel][index_] = value;
+
+            // Move the free slot to keep the window sorted.
+            while (position > 0 && sorted[position - 1] > value)
+            {
+                sorted[position] = sorted[position - 1];
+                --position;
+            }
+            const int count = size_ < WINDOW_SIZE ? size_ + 1 : size_;
+            while (position + 1 < count && sorted[position + 1] < value)
+            {
+                sorted[position] = sorted[position + 1];
+                ++position;
+            }
+            sorted[position] = value;
+
+            output_(channel) =
+                count % 2 == 1
+                    ? sorted[count / 2]
+                    : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+        }
+        if (size_ < WINDOW_SIZE)
+        {
+            ++size_;
+        }
+        index_ = (index_ + 1) % WINDOW_SIZE;
+        return output_;
+    }
+
+    /**
+     * @brief Get the output of the last call to filter().
+     */
+    const Vector& get_output() const
+    {
+        return output_;
+    }
+
+    /**
+     * @brief Number of samples in the window.
+     */
+    int size() const
+    {
+        return size_;
+    }
+
+private:
+    /** @brief Samples of each channel in arrival order. */
+    std::array<std::array<double, WINDOW_SIZE>, CHANNELS> history_;
+    /** @brief Samples of each channel sorted. */
+    std::array<std::array<double, WINDOW_SIZE>, CHANNELS> sorted_;
+    /** @brief Median of the window. */
+    Vector output_;
+    /** @brief Number of samples in the window. */
+    int size_;
+    /** @brief Slot of history_ of the next sample. */
+    int index_;
+};
+
+}  // namespace solo
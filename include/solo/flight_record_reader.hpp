@@ -0,0 +1,242 @@
+/**
+ * @file flight_record_reader.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Read back the files written by the FlightRecorder.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "solo/flight_recorder.hpp"
+
+namespace solo
+{
+/**
+ * @brief Give access, in chronological order, to the records of a flight
+ * record file.
+ *
+ * The file is mapped read-only so recordings of several hours can be read
+ * without loading them in memory. Files of a recorder that crashed are
+ * accepted: the most recent valid footer is used and the records written
+ * after it are recovered, partially written slots are skipped.
+ *
+ * @tparam Record The record type used by the FlightRecorder.
+ */
+template <class Record>
+class FlightRecordReader
+{
+public:
+    /** @brief The slot layout of the recorder. */
+    typedef typename FlightRecorder<Record>::Slot Slot;
+
+    /**
+     * @brief Open and validate a flight record file.
+     *
+     * @param file_path
+     */
+    FlightRecordReader(const std::string& file_path)
+    {
+        file_descriptor_ = ::open(file_path.c_str(), O_RDONLY);
+        if (file_descriptor_ < 0)
+        {
+            throw std::runtime_error("FlightRecordReader: cannot open " +
+                                     file_path + ": " + std::strerror(errno));
+        }
+        struct stat file_status;
+        if (::fstat(file_descriptor_, &file_status) != 0 ||
+            static_cast<std::size_t>(file_status.st_size) <
+                sizeof(FlightRecorderFileHeader))
+        {
+            ::close(file_descriptor_);
+            throw std::runtime_error("FlightRecordReader: " + file_path +
+                                     " is not a flight record file.");
+        }
+        file_size_ = file_status.st_size;
+        void* mapping = ::mmap(
+            nullptr, file_size_, PROT_READ, MAP_SHARED, file_descriptor_, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(file_descriptor_);
+            throw std::runtime_error("FlightRecordReader: cannot map " +
+                                     file_path + ": " + std::strerror(errno));
+        }
+        mapping_ = static_cast<const unsigned char*>(mapping);
+
+        try
+        {
+            parse(file_path);
+        }
+        catch (...)
+        {
+            ::munmap(const_cast<unsigned char*>(mapping_), file_size_);
+            ::close(file_descriptor_);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Release the file.
+     */
+    ~FlightRecordReader()
+    {
+        ::munmap(const_cast<unsigned char*>(mapping_), file_size_);
+        ::close(file_descriptor_);
+    }
+
+    FlightRecordReader(const FlightRecordReader&) = delete;
+    FlightRecordReader& operator=(const FlightRecordReader&) = delete;
+
+    /**
+     * @brief Number of readable records.
+     */
+    std::size_t size() const
+    {
+        return end_index_ - begin_index_;
+    }
+
+    /**
+     * @brief Get a record.
+     *
+     * @param i Chronological position in [0, size()), 0 is the oldest.
+     * @return const Record& Reference into the mapped file.
+     */
+    const Record& operator[](std::size_t i) const
+    {
+        return slots_[(begin_index_ + i) % capacity_].record;
+    }
+
+    /**
+     * @brief If the recorder was stopped cleanly, false after a crash.
+     */
+    bool is_clean_shutdown() const
+    {
+        return clean_shutdown_;
+    }
+
+    /**
+     * @brief Number of records the recorder had to drop during the run.
+     */
+    uint64_t get_dropped_count() const
+    {
+        return dropped_count_;
+    }
+
+    /**
+     * @brief Total number of records written during the run, including the
+     * ones overwritten in the ring.
+     */
+    uint64_t get_recorded_count() const
+    {
+        return end_index_;
+    }
+
+private:
+    /**
+     * @brief Check the header and find the range of valid records.
+     */
+    void parse(const std::string& file_path)
+    {
+        const FlightRecorderFileHeader* header =
+            reinterpret_cast<const FlightRecorderFileHeader*>(mapping_);
+        if (std::memcmp(header->magic, "SOLOFREC", 8) != 0 ||
+            header->version != FlightRecorder<Record>::FILE_VERSION)
+        {
+            throw std::runtime_error("FlightRecordReader: " + file_path +
+                                     " has an unknown format.");
+        }
+        if (header->slot_size != sizeof(Slot) ||
+            header->joint_count != Record::joint_count ||
+            header->motor_board_count != Record::motor_board_count)
+        {
+            throw std::runtime_error(
+                "FlightRecordReader: " + file_path +
+                " was recorded for another robot or record layout.");
+        }
+        capacity_ = header->capacity;
+        if (file_size_ != sizeof(FlightRecorderFileHeader) +
+                              capacity_ * sizeof(Slot) +
+                              2 * sizeof(FlightRecorderFileFooter))
+        {
+            throw std::runtime_error("FlightRecordReader: " + file_path +
+                                     " is truncated.");
+        }
+        slots_ = reinterpret_cast<const Slot*>(
+            mapping_ + sizeof(FlightRecorderFileHeader));
+        const FlightRecorderFileFooter* footers =
+            reinterpret_cast<const FlightRecorderFileFooter*>(
+                mapping_ + sizeof(FlightRecorderFileHeader) +
+                capacity_ * sizeof(Slot));
+
+        // Use the most recent footer with a valid checksum.
+        const FlightRecorderFileFooter* footer = nullptr;
+        for (int i = 0; i < 2; ++i)
+        {
+            if (footers[i].checksum == footers[i].compute_checksum() &&
+                (footer == nullptr || footers[i].sequence > footer->sequence))
+            {
+                footer = &footers[i];
+            }
+        }
+        if (footer == nullptr)
+        {
+            throw std::runtime_error("FlightRecordReader: " + file_path +
+                                     " has no valid footer.");
+        }
+        clean_shutdown_ = footer->clean_shutdown != 0;
+        dropped_count_ = footer->dropped_count;
+
+        // Recover the records written after the last footer update.
+        end_index_ = footer->record_count;
+        if (!clean_shutdown_)
+        {
+            while (end_index_ < footer->record_count + capacity_ &&
+                   slots_[end_index_ % capacity_].index == end_index_)
+            {
+                ++end_index_;
+            }
+        }
+
+        // Skip the slots that do not hold the expected record, e.g. the one
+        // being written during a crash.
+        begin_index_ = end_index_ > capacity_ ? end_index_ - capacity_ : 0;
+        while (begin_index_ < end_index_ &&
+               slots_[begin_index_ % capacity_].index != begin_index_)
+        {
+            ++begin_index_;
+        }
+    }
+
+    /** @brief File descriptor of the record file. */
+    int file_descriptor_;
+    /** @brief Size of the file (bytes). */
+    std::size_t file_size_;
+    /** @brief Start of the mapped file. */
+    const unsigned char* mapping_;
+    /** @brief First slot of the ring. */
+    const Slot* slots_;
+    /** @brief Number of slots in the ring. */
+    uint64_t capacity_;
+    /** @brief Index of the oldest readable record. */
+    uint64_t begin_index_;
+    /** @brief One past the index of the newest readable record. */
+    uint64_t end_index_;
+    /** @brief If the recorder was stopped cleanly. */
+    bool clean_shutdown_;
+    /** @brief Number of records dropped during the run. */
+    uint64_t dropped_count_;
+};
+
+}  // namespace solo
@@ -0,0 +1,504 @@
+/**
+ * @file flight_recorder.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Binary recorder of every control cycle into a memory mapped ring
+ * file.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "solo/sensor_frame.hpp"
+#include "solo/spsc_ring.hpp"
+
+namespace solo
+{
+/**
+ * @brief Fixed layout record of one control cycle.
+ *
+ * Only plain arrays are used so that the layout on disk does not depend on
+ * Eigen. Booleans are stored as uint8_t.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+struct FlightRecord
+{
+    /** @brief Number of joints of the recorded robot. */
+    static constexpr int joint_count = JOINT_COUNT;
+    /** @brief Number of motor boards of the recorded robot. */
+    static constexpr int motor_board_count = MOTOR_BOARD_COUNT;
+
+    /** @brief Index of the acquisition cycle, see SensorFrame::cycle. */
+    uint64_t cycle;
+    /** @brief Monotonic time of the acquisition (s). */
+    double timestamp;
+
+    /** @brief Joint positions (rad). */
+    double joint_positions[JOINT_COUNT];
+    /** @brief Joint velocities (rad/s). */
+    double joint_velocities[JOINT_COUNT];
+    /** @brief Measured joint torques (Nm). */
+    double joint_torques[JOINT_COUNT];
+    /** @brief Joint torques reported as sent by the hardware (Nm). */
+    double joint_target_torques[JOINT_COUNT];
+    /** @brief Joint torques commanded by the controller this cycle (Nm). */
+    double joint_commanded_torques[JOINT_COUNT];
+    /** @brief Position of the encoder indexes (rad). */
+    double joint_encoder_index[JOINT_COUNT];
+
+    /** @brief Slider positions in [0, 1]. */
+    double slider_positions[4];
+    /** @brief Contact sensor states. */
+    double contact_sensors_states[4];
+    /** @brief Base accelerometer. */
+    double imu_accelerometer[3];
+    /** @brief Base gyroscope. */
+    double imu_gyroscope[3];
+    /** @brief Base attitude (euler angles). */
+    double imu_attitude[3];
+    /** @brief Base linear acceleration. */
+    double imu_linear_acceleration[3];
+    /** @brief Base attitude quaternion ordered {x, y, z, w}. */
+    double imu_attitude_quaternion[4];
+
+    /** @brief Error code of each motor board. */
+    int32_t motor_board_errors[MOTOR_BOARD_COUNT];
+    /** @brief Enabled status of each motor. */
+    uint8_t motor_enabled[JOINT_COUNT];
+    /** @brief Ready status of each motor. */
+    uint8_t motor_ready[JOINT_COUNT];
+    /** @brief Enabled status of each motor board. */
+    uint8_t motor_board_enabled[MOTOR_BOARD_COUNT];
+
+    /** @brief If the soft estop is active. */
+    uint8_t active_estop;
+    /** @brief If the robot is ready to be controlled. */
+    uint8_t is_ready;
+    /** @brief If the joint calibration is running. */
+    uint8_t is_calibrating;
+    /** @brief If the hardware reports an error. */
+    uint8_t has_error;
+
+    /**
+     * @brief Fill the record from a sensor frame and the commanded torques.
+     *
+     * @param frame The sensor data of the cycle.
+     * @param commanded_torques The torques given to send_target_joint_torque.
+     */
+    void set(const SensorFrame<JOINT_COUNT, MOTOR_BOARD_COUNT>& frame,
+             const Eigen::Ref<const Eigen::Matrix<double, JOINT_COUNT, 1> >&
+                 commanded_torques)
+    {
+        cycle = frame.cycle;
+        timestamp = frame.timestamp;
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            joint_positions[i] = frame.joint_positions(i);
+            joint_velocities[i] = frame.joint_velocities(i);
+            joint_torques[i] = frame.joint_torques(i);
+            joint_target_torques[i] = frame.joint_target_torques(i);
+            joint_commanded_torques[i] = commanded_torques(i);
+            joint_encoder_index[i] = frame.joint_encoder_index(i);
+            motor_enabled[i] = frame.motor_enabled[i];
+            motor_ready[i] = frame.motor_ready[i];
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            slider_positions[i] = frame.slider_positions(i);
+            contact_sensors_states[i] = frame.contact_sensors_states(i);
+            imu_attitude_quaternion[i] = frame.imu_attitude_quaternion(i);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            imu_accelerometer[i] = frame.imu_accelerometer(i);
+            imu_gyroscope[i] = frame.imu_gyroscope(i);
+            imu_attitude[i] = frame.imu_attitude(i);
+            imu_linear_acceleration[i] = frame.imu_linear_acceleration(i);
+        }
+        for (int i = 0; i < MOTOR_BOARD_COUNT; ++i)
+        {
+            motor_board_errors[i] = frame.motor_board_errors[i];
+            motor_board_enabled[i] = frame.motor_board_enabled[i];
+        }
+        active_estop = frame.active_estop;
+        is_ready = frame.is_ready;
+        is_calibrating = frame.is_calibrating;
+        has_error = frame.has_error;
+    }
+};
+
+/**
+ * @brief Header at the beginning of a flight record file.
+ */
+struct FlightRecorderFileHeader
+{
+    /** @brief Always "SOLOFREC". */
+    char magic[8];
+    /** @brief Version of the file layout. */
+    uint32_t version;
+    /** @brief Size of one slot of the ring (bytes). */
+    uint32_t slot_size;
+    /** @brief Number of joints of the recorded robot. */
+    uint32_t joint_count;
+    /** @brief Number of motor boards of the recorded robot. */
+    uint32_t motor_board_count;
+    /** @brief Number of slots in the ring. */
+    uint64_t capacity;
+};
+
+/**
+ * @brief Footer at the end of a flight record file.
+ *
+ * The file ends with two footers written alternately, each protected by a
+ * checksum. After a crash the valid footer with the highest sequence tells
+ * which records made it to the file, even if the process died in the middle
+ * of a footer update.
+ */
+struct FlightRecorderFileFooter
+{
+    /** @brief Number of footer updates, selects the most recent footer. */
+    uint64_t sequence;
+    /** @brief Total number of records written to the ring. */
+    uint64_t record_count;
+    /** @brief Number of records lost because the writer was too slow. */
+    uint64_t dropped_count;
+    /** @brief 1 if the recorder was stopped cleanly, 0 else. */
+    uint64_t clean_shutdown;
+    /** @brief FNV-1a hash of the fields above. */
+    uint64_t checksum;
+
+    /**
+     * @brief Compute the checksum of the footer content.
+     */
+    uint64_t compute_checksum() const
+    {
+        const unsigned char* bytes =
+            reinterpret_cast<const unsigned char*>(this);
+        uint64_t hash = 1469598103934665603ULL;
+        for (std::size_t i = 0; i < offsetof(FlightRecorderFileFooter, checksum);
+             ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+};
+
+/**
+ * @brief Record fixed layout records into a memory mapped ring file.
+ *
+ * The real time thread calls record(), which only copies the record into a
+ * preallocated in-memory queue. A background thread drains this queue into
+ * the memory mapped file, overwriting the oldest records once the ring is
+ * full, and then updates the footer. The file therefore always contains the
+ * last `capacity` cycles. Because the file is mapped shared, everything the
+ * background thread wrote survives a crash of the process; only the records
+ * still in the in-memory queue (a few milliseconds) are lost.
+ *
+ * Layout of the file: FlightRecorderFileHeader, then `capacity` slots made of
+ * a uint64_t record index followed by the record, then two
+ * FlightRecorderFileFooter. Use FlightRecordReader to read it back.
+ *
+ * @tparam Record Trivially copyable record type, e.g. FlightRecord.
+ */
+template <class Record>
+class FlightRecorder
+{
+public:
+    static_assert(std::is_trivially_copyable<Record>::value,
+                  "FlightRecorder: the record must be trivially copyable.");
+
+    /** @brief Version of the file layout written by this class. */
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    /** @brief Index of a slot being written. */
+    static constexpr uint64_t INVALID_INDEX = ~uint64_t(0);
+
+    /**
+     * @brief One entry of the ring in the file.
+     */
+    struct Slot
+    {
+        /** @brief Index of the record since the start of the recording. */
+        uint64_t index;
+        /** @brief The recorded data. */
+        Record record;
+    };
+
+    /**
+     * @brief Create the file and start the background writer.
+     *
+     * @param file_path Path of the ring file, overwritten if it exists.
+     * @param capacity Number of records kept in the file, e.g. 3600000 for
+     * one hour at 1kHz.
+     * @param queue_capacity Size of the in-memory queue between the real time
+     * thread and the writer (power of two).
+     * @param sync_period Period of the asynchronous flush of the file to the
+     * disk (s).
+     */
+    FlightRecorder(const std::string& file_path,
+                   uint64_t capacity,
+                   std::size_t queue_capacity = 4096,
+                   double sync_period = 1.0)
+        : queue_(queue_capacity),
+          file_path_(file_path),
+          capacity_(capacity),
+          sync_period_(sync_period),
+          record_count_(0),
+          footer_sequence_(0),
+          dropped_count_(0),
+          is_running_(true),
+          is_stopped_(false)
+    {
+        if (capacity_ == 0)
+        {
+            throw std::invalid_argument(
+                "FlightRecorder: the capacity must be positive.");
+        }
+
+        file_size_ = sizeof(FlightRecorderFileHeader) + capacity_ * sizeof(Slot) +
+                     2 * sizeof(FlightRecorderFileFooter);
+        file_descriptor_ =
+            ::open(file_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (file_descriptor_ < 0)
+        {
+            throw std::runtime_error("FlightRecorder: cannot open " +
+                                     file_path_ + ": " + std::strerror(errno));
+        }
+        if (::ftruncate(file_descriptor_, file_size_) != 0)
+        {
+            ::close(file_descriptor_);
+            throw std::runtime_error("FlightRecorder: cannot resize " +
+                                     file_path_ + ": " + std::strerror(errno));
+        }
+        void* mapping = ::mmap(nullptr,
+                               file_size_,
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED,
+                               file_descriptor_,
+                               0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(file_descriptor_);
+            throw std::runtime_error("FlightRecorder: cannot map " +
+                                     file_path_ + ": " + std::strerror(errno));
+        }
+        mapping_ = static_cast<unsigned char*>(mapping);
+
+        FlightRecorderFileHeader* header =
+            reinterpret_cast<FlightRecorderFileHeader*>(mapping_);
+        std::memcpy(header->magic, "SOLOFREC", 8);
+        header->version = FILE_VERSION;
+        header->slot_size = sizeof(Slot);
+        header->joint_count = Record::joint_count;
+        header->motor_board_count = Record::motor_board_count;
+        header->capacity = capacity_;
+        slots_ = reinterpret_cast<Slot*>(mapping_ +
+                                         sizeof(FlightRecorderFileHeader));
+        footers_ = reinterpret_cast<FlightRecorderFileFooter*>(
+            mapping_ + sizeof(FlightRecorderFileHeader) +
+            capacity_ * sizeof(Slot));
+        write_footer(false);
+
+        writer_thread_ = std::thread(&FlightRecorder::writer_loop, this);
+    }
+
+    /**
+     * @brief Stop the recording, see stop().
+     */
+    ~FlightRecorder()
+    {
+        stop();
+    }
+
+    /**
+     * @brief Queue one record. Bounded cost, never blocks nor allocates.
+     *
+     * Must always be called from the same thread.
+     *
+     * @param record
+     * @return true if queued, false if the queue was full or the recorder
+     * stopped, and the record was dropped.
+     */
+    bool record(const Record& record)
+    {
+        if (!is_running_.load(std::memory_order_acquire) ||
+            !queue_.push(record))
+        {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Write the queued records, mark the file as cleanly closed, flush
+     * it to the disk and release it. Further records are dropped.
+     */
+    void stop()
+    {
+        if (!is_running_.exchange(false))
+        {
+            return;
+        }
+        writer_thread_.join();
+        drain_queue();
+        write_footer(true);
+        ::msync(mapping_, file_size_, MS_SYNC);
+        ::munmap(mapping_, file_size_);
+        ::close(file_descriptor_);
+        is_stopped_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Number of records dropped because the queue was full or the
+     * recorder stopped, including the records queued while stop() ran and
+     * left unwritten.
+     */
+    uint64_t get_dropped_count() const
+    {
+        const uint64_t left_count =
+            is_stopped_.load(std::memory_order_acquire) ? queue_.size() : 0;
+        return dropped_count_.load(std::memory_order_relaxed) + left_count;
+    }
+
+    /**
+     * @brief Path of the ring file.
+     */
+    const std::string& get_file_path() const
+    {
+        return file_path_;
+    }
+
+private:
+    /**
+     * @brief Background thread: periodically move the queued records into the
+     * file.
+     */
+    void writer_loop()
+    {
+        std::chrono::steady_clock::time_point last_sync =
+            std::chrono::steady_clock::now();
+        while (is_running_.load())
+        {
+            if (drain_queue() > 0)
+            {
+                write_footer(false);
+            }
+            std::chrono::steady_clock::time_point now =
+                std::chrono::steady_clock::now();
+            if (std::chrono::duration<double>(now - last_sync).count() >
+                sync_period_)
+            {
+                ::msync(mapping_, file_size_, MS_ASYNC);
+                last_sync = now;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    /**
+     * @brief Move all the queued records into the ring of the file.
+     *
+     * @return std::size_t The number of records written.
+     */
+    std::size_t drain_queue()
+    {
+        std::size_t count = 0;
+        while (queue_.pop(pending_record_))
+        {
+            // Invalidate the slot while the record is copied so a reader
+            // never accepts a partially written record.
+            Slot& slot = slots_[record_count_ % capacity_];
+            slot.index = INVALID_INDEX;
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&slot.record, &pending_record_, sizeof(Record));
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.index = record_count_;
+            ++record_count_;
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Update the oldest of the two footers.
+     *
+     * @param clean_shutdown If the recording is complete.
+     */
+    void write_footer(bool clean_shutdown)
+    {
+        // Make sure the records are in the mapping before the footer that
+        // announces them.
+        std::atomic_thread_fence(std::memory_order_release);
+        ++footer_sequence_;
+        FlightRecorderFileFooter footer;
+        footer.sequence = footer_sequence_;
+        footer.record_count = record_count_;
+        footer.dropped_count = get_dropped_count();
+        footer.clean_shutdown = clean_shutdown ? 1 : 0;
+        footer.checksum = footer.compute_checksum();
+        std::memcpy(&footers_[footer_sequence_ % 2], &footer, sizeof(footer));
+    }
+
+    /** @brief Queue between the real time thread and the writer. */
+    SpscRing<Record> queue_;
+    /** @brief Record being moved by the writer thread. */
+    Record pending_record_;
+
+    /** @brief Path of the ring file. */
+    std::string file_path_;
+    /** @brief Number of slots in the file. */
+    uint64_t capacity_;
+    /** @brief Period of the asynchronous flush (s). */
+    double sync_period_;
+    /** @brief Size of the file (bytes). */
+    std::size_t file_size_;
+    /** @brief File descriptor of the ring file. */
+    int file_descriptor_;
+    /** @brief Start of the mapped file. */
+    unsigned char* mapping_;
+    /** @brief First slot of the ring in the mapping. */
+    Slot* slots_;
+    /** @brief The two footers in the mapping. */
+    FlightRecorderFileFooter* footers_;
+
+    /** @brief Number of records written to the file, writer thread only. */
+    uint64_t record_count_;
+    /** @brief Number of footer updates, writer thread only. */
+    uint64_t footer_sequence_;
+    /** @brief Number of records dropped by record(). */
+    std::atomic<uint64_t> dropped_count_;
+
+    /** @brief False once stop() is called. */
+    std::atomic_bool is_running_;
+    /** @brief True once stop() released the file. */
+    std::atomic_bool is_stopped_;
+    /** @brief Background writer. */
+    std::thread writer_thread_;
+};
+
+}  // namespace solo
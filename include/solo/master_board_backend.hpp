@@ -0,0 +1,529 @@
+/**
+ * @file master_board_backend.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Hardware abstraction between the robot classes and the master board.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <Eigen/Eigen>
+#include <odri_control_interface/calibration.hpp>
+#include <odri_control_interface/robot.hpp>
+
+namespace solo
+{
+/**
+ * @brief Description of a robot driven through a master board.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ */
+template <int JOINT_COUNT>
+struct MasterBoardBackendConfig
+{
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+
+    /** @brief Name of the ethernet interface, left column of ifconfig. */
+    std::string network_id;
+    /** @brief Motor index of each joint. */
+    std::array<int, JOINT_COUNT> motor_numbers;
+    /** @brief If the motor turns opposite to the joint. */
+    std::array<bool, JOINT_COUNT> motor_reversed;
+    /** @brief Motor torque constant (Nm/A). */
+    double motor_torque_constant;
+    /** @brief Joint gear ratio. */
+    double joint_gear_ratio;
+    /** @brief Maximum motor current (A). */
+    double motor_max_current;
+    /** @brief Lower joint limits (rad). */
+    JointVector joint_lower_limits;
+    /** @brief Upper joint limits (rad). */
+    JointVector joint_upper_limits;
+    /** @brief Joint velocity above which an error is reported (rad/s). */
+    double max_joint_velocity;
+    /** @brief Damping applied to the joints after an error (Nm s/rad). */
+    double safety_damping;
+    /** @brief Axis mapping of the imu. */
+    std::array<long, 3> imu_rotate_vector;
+    /** @brief Quaternion component mapping of the imu. */
+    std::array<long, 4> imu_orientation_vector;
+    /** @brief Search direction of the encoder index of each joint. */
+    std::array<odri_control_interface::CalibrationMethod, JOINT_COUNT>
+        calibration_directions;
+    /** @brief Proportional gain of the calibration controller. */
+    double calibration_kp;
+    /** @brief Derivative gain of the calibration controller. */
+    double calibration_kd;
+    /** @brief Duration of the calibration motions (s). */
+    double calibration_duration;
+    /** @brief Control period during the calibration (s). */
+    double calibration_dt;
+};
+
+/**
+ * @brief Interface to the master board used by the robot classes.
+ *
+ * It gathers the few operations the robots need from odri_control_interface
+ * (Robot, JointModules, IMU and JointCalibrator) behind one virtual interface
+ * so the hardware can be replaced, e.g. by the FakeMasterBoardBackend. All the
+ * data is exchanged in fixed size containers.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+class MasterBoardBackend
+{
+public:
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+
+    virtual ~MasterBoardBackend()
+    {
+    }
+
+    /**
+     * @brief Open the connection and enable the motor boards.
+     */
+    virtual void init() = 0;
+
+    /**
+     * @brief Send the initialization packet, until is_ack_msg_received().
+     */
+    virtual void send_init() = 0;
+
+    /**
+     * @brief Send the current commands to the motor boards.
+     */
+    virtual void send_command() = 0;
+
+    /**
+     * @brief Read the latest packet of the master board. Updates all the
+     * getters.
+     */
+    virtual void parse_sensor_data() = 0;
+
+    /** @brief If the master board acknowledged the initialization. */
+    virtual bool is_ack_msg_received() = 0;
+
+    /** @brief If the connection with the master board timed out. */
+    virtual bool is_timeout() = 0;
+
+    /** @brief If all the motors are enabled and aligned. */
+    virtual bool is_ready() = 0;
+
+    /** @brief If an error was detected or reported. */
+    virtual bool has_error() = 0;
+
+    /**
+     * @brief Put the robot in the safe error state.
+     *
+     * Called from the control loop, so it must not allocate.
+     *
+     * @param message Printed reason.
+     */
+    virtual void report_error(const char* message) = 0;
+
+    /**
+     * @brief Set the torques sent by the next send_command().
+     *
+     * @param torques (Nm)
+     */
+    virtual void set_torques(const JointVector& torques) = 0;
+
+    /**
+     * @brief Send zero torques, gains and set points at the next
+     * send_command().
+     */
+    virtual void set_zero_commands() = 0;
+
+    /**
+     * @brief Set the current limit of all the motors.
+     *
+     * @param max_current (A)
+     */
+    virtual void set_maximum_current(double max_current) = 0;
+
+    /**
+     * @brief Set the joint positions at the encoder indexes used by the next
+     * calibration.
+     *
+     * @param position_offsets (rad)
+     */
+    virtual void set_calibration_offsets(
+        const JointVector& position_offsets) = 0;
+
+    /**
+     * @brief Compute the commands of one calibration step.
+     *
+     * @return true once the calibration is done.
+     */
+    virtual bool run_calibration() = 0;
+
+    /**
+     * @brief Apply the offsets of a previous calibration without moving, if
+     * the motor boards still know the encoder index of every joint, i.e.
+     * they were not power cycled since.
+     *
+     * @param position_offsets Offsets of the previous calibration (rad).
+     * @return false if an index is unknown: the full calibration is needed.
+     */
+    virtual bool restore_calibration(const JointVector& position_offsets) = 0;
+
+    /*
+     * Data updated by parse_sensor_data().
+     */
+
+    /** @brief Joint positions (rad). */
+    virtual const JointVector& get_joint_positions() const = 0;
+    /** @brief Joint velocities (rad/s). */
+    virtual const JointVector& get_joint_velocities() const = 0;
+    /** @brief Measured joint torques (Nm). */
+    virtual const JointVector& get_joint_measured_torques() const = 0;
+    /** @brief Joint torques sent to the motors (Nm). */
+    virtual const JointVector& get_joint_sent_torques() const = 0;
+    /** @brief Base accelerometer. */
+    virtual const Eigen::Vector3d& get_imu_accelerometer() const = 0;
+    /** @brief Base gyroscope. */
+    virtual const Eigen::Vector3d& get_imu_gyroscope() const = 0;
+    /** @brief Base attitude (euler angles). */
+    virtual const Eigen::Vector3d& get_imu_attitude() const = 0;
+    /** @brief Base linear acceleration. */
+    virtual const Eigen::Vector3d& get_imu_linear_acceleration() const = 0;
+    /** @brief Base attitude quaternion ordered {x, y, z, w}. */
+    virtual const Eigen::Vector4d& get_imu_attitude_quaternion() const = 0;
+    /** @brief Enabled status of each motor (joint ordering). */
+    virtual const std::array<bool, JOINT_COUNT>& get_motor_enabled()
+        const = 0;
+    /** @brief Ready status of each motor (joint ordering). */
+    virtual const std::array<bool, JOINT_COUNT>& get_motor_ready() const = 0;
+    /** @brief Enabled status of each motor board. */
+    virtual const std::array<bool, MOTOR_BOARD_COUNT>&
+    get_motor_board_enabled() const = 0;
+    /** @brief Error code of each motor board. */
+    virtual const std::array<int, MOTOR_BOARD_COUNT>& get_motor_board_errors()
+        const = 0;
+};
+
+/**
+ * @brief Master board backend talking to the real hardware through
+ * odri_control_interface.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+class OdriMasterBoardBackend
+    : public MasterBoardBackend<JOINT_COUNT, MOTOR_BOARD_COUNT>
+{
+public:
+    typedef typename MasterBoardBackend<JOINT_COUNT,
+                                        MOTOR_BOARD_COUNT>::JointVector
+        JointVector;
+
+    /**
+     * @brief Create the odri objects. Nothing is sent before init().
+     *
+     * @param config
+     */
+    OdriMasterBoardBackend(const MasterBoardBackendConfig<JOINT_COUNT>& config)
+    {
+        using namespace odri_control_interface;
+
+        main_board_ptr_ =
+            std::make_shared<MasterBoardInterface>(config.network_id);
+
+        VectorXi motor_numbers(JOINT_COUNT);
+        VectorXb motor_reversed(JOINT_COUNT);
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            motor_numbers(i) = config.motor_numbers[i];
+            motor_reversed(i) = config.motor_reversed[i];
+        }
+        Eigen::VectorXd joint_lower_limits = config.joint_lower_limits;
+        Eigen::VectorXd joint_upper_limits = config.joint_upper_limits;
+
+        // Define the joint module.
+        joints_ = std::make_shared<JointModules>(main_board_ptr_,
+                                                 motor_numbers,
+                                                 config.motor_torque_constant,
+                                                 config.joint_gear_ratio,
+                                                 config.motor_max_current,
+                                                 motor_reversed,
+                                                 joint_lower_limits,
+                                                 joint_upper_limits,
+                                                 config.max_joint_velocity,
+                                                 config.safety_damping);
+
+        // Define the IMU.
+        VectorXl rotate_vector(3);
+        rotate_vector << config.imu_rotate_vector[0],
+            config.imu_rotate_vector[1], config.imu_rotate_vector[2];
+        VectorXl orientation_vector(4);
+        orientation_vector << config.imu_orientation_vector[0],
+            config.imu_orientation_vector[1], config.imu_orientation_vector[2],
+            config.imu_orientation_vector[3];
+        imu_ = std::make_shared<IMU>(
+            main_board_ptr_, rotate_vector, orientation_vector);
+
+        // Define the robot.
+        robot_ = std::make_shared<Robot>(main_board_ptr_, joints_, imu_);
+
+        std::vector<CalibrationMethod> directions(
+            config.calibration_directions.begin(),
+            config.calibration_directions.end());
+
+        // Use zero position offsets for now. Gets updated before the
+        // calibration.
+        Eigen::VectorXd position_offsets(JOINT_COUNT);
+        position_offsets.fill(0.);
+        calib_ctrl_ =
+            std::make_shared<JointCalibrator>(robot_->joints,
+                                              directions,
+                                              position_offsets,
+                                              config.calibration_kp,
+                                              config.calibration_kd,
+                                              config.calibration_duration,
+                                              config.calibration_dt);
+
+        joint_positions_.setZero();
+        joint_velocities_.setZero();
+        joint_measured_torques_.setZero();
+        joint_sent_torques_.setZero();
+        imu_accelerometer_.setZero();
+        imu_gyroscope_.setZero();
+        imu_attitude_.setZero();
+        imu_linear_acceleration_.setZero();
+        imu_attitude_quaternion_ << 0.0, 0.0, 0.0, 1.0;
+        motor_enabled_.fill(false);
+        motor_ready_.fill(false);
+        motor_board_enabled_.fill(false);
+        motor_board_errors_.fill(0);
+    }
+
+    void init()
+    {
+        robot_->Init();
+    }
+
+    void send_init()
+    {
+        robot_->SendInit();
+    }
+
+    void send_command()
+    {
+        robot_->SendCommand();
+    }
+
+    void parse_sensor_data()
+    {
+        robot_->ParseSensorData();
+
+        joint_positions_ = joints_->GetPositions();
+        joint_velocities_ = joints_->GetVelocities();
+        joint_measured_torques_ = joints_->GetMeasuredTorques();
+        joint_sent_torques_ = joints_->GetSentTorques();
+
+        imu_accelerometer_ = imu_->GetAccelerometer();
+        imu_gyroscope_ = imu_->GetGyroscope();
+        imu_attitude_ = imu_->GetAttitudeEuler();
+        imu_linear_acceleration_ = imu_->GetLinearAcceleration();
+        imu_attitude_quaternion_ = imu_->GetAttitudeQuaternion();
+
+        odri_control_interface::ConstRefVectorXb motor_enabled =
+            joints_->GetEnabled();
+        odri_control_interface::ConstRefVectorXb motor_ready =
+            joints_->GetReady();
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            motor_enabled_[i] = motor_enabled[i];
+            motor_ready_[i] = motor_ready[i];
+        }
+        odri_control_interface::ConstRefVectorXi motor_board_errors =
+            joints_->GetMotorDriverErrors();
+        odri_control_interface::ConstRefVectorXb motor_board_enabled =
+            joints_->GetMotorDriverEnabled();
+        for (int i = 0; i < MOTOR_BOARD_COUNT; ++i)
+        {
+            motor_board_errors_[i] = motor_board_errors[i];
+            motor_board_enabled_[i] = motor_board_enabled[i];
+        }
+    }
+
+    bool is_ack_msg_received()
+    {
+        return robot_->IsAckMsgReceived();
+    }
+
+    bool is_timeout()
+    {
+        return robot_->IsTimeout();
+    }
+
+    bool is_ready()
+    {
+        return robot_->IsReady();
+    }
+
+    bool has_error()
+    {
+        return robot_->HasError();
+    }
+
+    void report_error(const char* message)
+    {
+        // Robot::ReportError(const std::string&) would allocate the message.
+        std::fprintf(stderr, "ERROR: %s\n", message);
+        robot_->ReportError();
+    }
+
+    void set_torques(const JointVector& torques)
+    {
+        joints_->SetTorques(torques);
+    }
+
+    void set_zero_commands()
+    {
+        joints_->SetZeroCommands();
+    }
+
+    void set_maximum_current(double max_current)
+    {
+        joints_->SetMaximumCurrents(max_current);
+    }
+
+    void set_calibration_offsets(const JointVector& position_offsets)
+    {
+        // Passed by reference, without a dynamic size copy.
+        calib_ctrl_->UpdatePositionOffsets(position_offsets);
+    }
+
+    bool run_calibration()
+    {
+        return calib_ctrl_->Run();
+    }
+
+    /**
+     * @brief The udriver boards latch the index detection while powered:
+     * apply the offsets and the index compensation like the end of a
+     * JointCalibrator run.
+     */
+    bool restore_calibration(const JointVector& position_offsets)
+    {
+        if (!joints_->HasIndexBeenDetected().all())
+        {
+            return false;
+        }
+        joints_->SetPositionOffsets(position_offsets);
+        joints_->EnableIndexOffsetCompensation();
+        return true;
+    }
+
+    const JointVector& get_joint_positions() const
+    {
+        return joint_positions_;
+    }
+    const JointVector& get_joint_velocities() const
+    {
+        return joint_velocities_;
+    }
+    const JointVector& get_joint_measured_torques() const
+    {
+        return joint_measured_torques_;
+    }
+    const JointVector& get_joint_sent_torques() const
+    {
+        return joint_sent_torques_;
+    }
+    const Eigen::Vector3d& get_imu_accelerometer() const
+    {
+        return imu_accelerometer_;
+    }
+    const Eigen::Vector3d& get_imu_gyroscope() const
+    {
+        return imu_gyroscope_;
+    }
+    const Eigen::Vector3d& get_imu_attitude() const
+    {
+        return imu_attitude_;
+    }
+    const Eigen::Vector3d& get_imu_linear_acceleration() const
+    {
+        return imu_linear_acceleration_;
+    }
+    const Eigen::Vector4d& get_imu_attitude_quaternion() const
+    {
+        return imu_attitude_quaternion_;
+    }
+    const std::array<bool, JOINT_COUNT>& get_motor_enabled() const
+    {
+        return motor_enabled_;
+    }
+    const std::array<bool, JOINT_COUNT>& get_motor_ready() const
+    {
+        return motor_ready_;
+    }
+    const std::array<bool, MOTOR_BOARD_COUNT>& get_motor_board_enabled() const
+    {
+        return motor_board_enabled_;
+    }
+    const std::array<int, MOTOR_BOARD_COUNT>& get_motor_board_errors() const
+    {
+        return motor_board_errors_;
+    }
+
+private:
+    /**
+     * @brief Main board drivers.
+     *
+     * PC <- Ethernet/Wifi -> main board <- SPI -> Motor Board
+     */
+    std::shared_ptr<MasterBoardInterface> main_board_ptr_;
+    /** @brief The odri robot abstraction. */
+    std::shared_ptr<odri_control_interface::Robot> robot_;
+    /** @brief Collection of joints. */
+    std::shared_ptr<odri_control_interface::JointModules> joints_;
+    /** @brief Robot imu drivers. */
+    std::shared_ptr<odri_control_interface::IMU> imu_;
+    /** @brief Controller to run the calibration procedure. */
+    std::shared_ptr<odri_control_interface::JointCalibrator> calib_ctrl_;
+
+    /** @brief Joint positions (rad). */
+    JointVector joint_positions_;
+    /** @brief Joint velocities (rad/s). */
+    JointVector joint_velocities_;
+    /** @brief Measured joint torques (Nm). */
+    JointVector joint_measured_torques_;
+    /** @brief Joint torques sent to the motors (Nm). */
+    JointVector joint_sent_torques_;
+    /** @brief Base accelerometer. */
+    Eigen::Vector3d imu_accelerometer_;
+    /** @brief Base gyroscope. */
+    Eigen::Vector3d imu_gyroscope_;
+    /** @brief Base attitude (euler angles). */
+    Eigen::Vector3d imu_attitude_;
+    /** @brief Base linear acceleration. */
+    Eigen::Vector3d imu_linear_acceleration_;
+    /** @brief Base attitude quaternion ordered {x, y, z, w}. */
+    Eigen::Vector4d imu_attitude_quaternion_;
+    /** @brief Enabled status of each motor. */
+    std::array<bool, JOINT_COUNT> motor_enabled_;
+    /** @brief Ready status of each motor. */
+    std::array<bool, JOINT_COUNT> motor_ready_;
+    /** @brief Enabled status of each motor board. */
+    std::array<bool, MOTOR_BOARD_COUNT> motor_board_enabled_;
+    /** @brief Error code of each motor board. */
+    std::array<int, MOTOR_BOARD_COUNT> motor_board_errors_;
+};
+
+}  // namespace solo
@@ -0,0 +1,271 @@
+/**
+ * @file master_board_io_threads.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Concurrent exchange of packets with several master boards.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "master_board_sdk/master_board_interface.h"
+
+namespace solo
+{
+/**
+ * @brief Run SendCommand() and ParseSensorData() of several master boards
+ * at the same time.
+ *
+ * Each master board sits on its own network interface, so the packets can be
+ * exchanged concurrently. The first board is served by the calling thread and
+ * every other board by a dedicated I/O thread. A call returns once all the
+ * boards are done, so the control loop sees the data of every board from the
+ * same cycle.
+ *
+ * The requests are handed over through atomics only. The I/O threads spin
+ * for a while after each request, by default two periods of a 1 kHz loop,
+ * so the next request is served without a wake up latency. Only once idle
+ * for longer do they sleep on a condition variable, and only then does the
+ * calling thread take a mutex, to wake them up. They ask for the SCHED_FIFO
+ * policy and silently keep the default one without the permissions.
+ *
+ * Spinning needs a free core per I/O thread: on a machine with fewer cores,
+ * give a zero spin duration. The master_board_io_threads_* benchmarks
+ * compare the concurrent exchange with the sequential one.
+ *
+ * @tparam BOARD_COUNT Number of master boards.
+ * @tparam Board Master board interface, with SendCommand() and
+ * ParseSensorData().
+ */
+template <int BOARD_COUNT, class Board = MasterBoardInterface>
+class MasterBoardIoThreads
+{
+    static_assert(BOARD_COUNT > 0, "At least one master board is needed.");
+
+public:
+    /** @brief The master boards, in board index order. */
+    typedef std::array<std::shared_ptr<Board>, BOARD_COUNT> Boards;
+
+    /**
+     * @brief Start one I/O thread per board but the first.
+     *
+     * @param boards
+     * @param thread_priority SCHED_FIFO priority of the I/O threads.
+     * @param spin_duration Time an idle I/O thread polls for the next
+     * request before sleeping (s), longer than the period of the loop.
+     */
+    MasterBoardIoThreads(const Boards& boards,
+                         int thread_priority = 80,
+                         double spin_duration = 0.002)
+        : boards_(boards)
+    {
+        spin_duration_ = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(spin_duration));
+        for (int i = 1; i < BOARD_COUNT; ++i)
+        {
+            workers_[i].reset(new Worker());
+            workers_[i]->thread =
+                std::thread(&MasterBoardIoThreads::worker_loop, this, i);
+            sched_param parameters;
+            parameters.sched_priority = thread_priority;
+            pthread_setschedparam(workers_[i]->thread.native_handle(),
+                                  SCHED_FIFO,
+                                  &parameters);
+        }
+    }
+
+    /**
+     * @brief Stop and join the I/O threads.
+     */
+    ~MasterBoardIoThreads()
+    {
+        for (int i = 1; i < BOARD_COUNT; ++i)
+        {
+            post(i, operation_stop);
+            workers_[i]->thread.join();
+        }
+    }
+
+    MasterBoardIoThreads(const MasterBoardIoThreads&) = delete;
+    MasterBoardIoThreads& operator=(const MasterBoardIoThreads&) = delete;
+
+    /**
+     * @brief SendCommand() on all the boards concurrently.
+     */
+    void send_command()
+    {
+        run(operation_send_command);
+    }
+
+    /**
+     * @brief ParseSensorData() on all the boards concurrently.
+     */
+    void parse_sensor_data()
+    {
+        run(operation_parse_sensor_data);
+    }
+
+    /**
+     * @brief Get one of the master boards.
+     */
+    const std::shared_ptr<Board>& get_board(int board) const
+    {
+        return boards_[board];
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /** @brief Request sent to an I/O thread. */
+    enum Operation
+    {
+        operation_send_command,
+        operation_parse_sensor_data,
+        operation_stop
+    };
+
+    /** @brief Number of polls between two reads of the clock. */
+    static constexpr int polls_per_clock_read = 64;
+
+    /** @brief State shared with one I/O thread. */
+    struct Worker
+    {
+        Worker()
+            : operation(operation_send_command),
+              request(0),
+              done(0),
+              sleeping(false)
+        {
+        }
+
+        std::thread thread;
+        /** @brief Operation of the last request. */
+        std::atomic<int> operation;
+        /** @brief Number of requests posted. */
+        std::atomic<uint64_t> request;
+        /** @brief Number of requests executed. */
+        std::atomic<uint64_t> done;
+        /** @brief If the thread waits, or is about to, on the condition. */
+        std::atomic<bool> sleeping;
+        /** @brief Only taken to go to sleep and to wake up the thread. */
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    /**
+     * @brief Execute an operation on every board and wait for all of them.
+     */
+    void run(Operation operation)
+    {
+        for (int i = 1; i < BOARD_COUNT; ++i)
+        {
+            post(i, operation);
+        }
+        execute(0, operation);
+        for (int i = 1; i < BOARD_COUNT; ++i)
+        {
+            const uint64_t request =
+                workers_[i]->request.load(std::memory_order_relaxed);
+            while (workers_[i]->done.load(std::memory_order_acquire) !=
+                   request)
+            {
+            }
+        }
+    }
+
+    /**
+     * @brief Hand an operation to the I/O thread of a board. Lock free while
+     * the thread spins.
+     */
+    void post(int board, Operation operation)
+    {
+        Worker& worker = *workers_[board];
+        worker.operation.store(operation, std::memory_order_relaxed);
+        // Sequentially consistent with the sleeping flag: either the thread
+        // sees the request before sleeping, or this sees it asleep.
+        worker.request.fetch_add(1, std::memory_order_seq_cst);
+        if (worker.sleeping.load(std::memory_order_seq_cst))
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.condition.notify_one();
+        }
+    }
+
+    void execute(int board, int operation)
+    {
+        if (operation == operation_send_command)
+        {
+            boards_[board]->SendCommand();
+        }
+        else if (operation == operation_parse_sensor_data)
+        {
+            boards_[board]->ParseSensorData();
+        }
+    }
+
+    /**
+     * @brief Body of the I/O thread of a board.
+     */
+    void worker_loop(int board)
+    {
+        Worker& worker = *workers_[board];
+        uint64_t served = 0;
+        while (true)
+        {
+            const Clock::time_point spin_end = Clock::now() + spin_duration_;
+            int polls = 0;
+            while (worker.request.load(std::memory_order_acquire) == served)
+            {
+                if (++polls < polls_per_clock_read)
+                {
+                    continue;
+                }
+                polls = 0;
+                if (Clock::now() < spin_end)
+                {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(worker.mutex);
+                worker.sleeping.store(true, std::memory_order_seq_cst);
+                worker.condition.wait(lock, [&worker, served]() {
+                    return worker.request.load(std::memory_order_seq_cst) !=
+                           served;
+                });
+                worker.sleeping.store(false, std::memory_order_relaxed);
+            }
+            ++served;
+            const int operation =
+                worker.operation.load(std::memory_order_relaxed);
+            if (operation == operation_stop)
+            {
+                worker.done.store(served, std::memory_order_release);
+                return;
+            }
+            execute(board, operation);
+            worker.done.store(served, std::memory_order_release);
+        }
+    }
+
+    /** @brief The master boards. */
+    Boards boards_;
+    /** @brief Time an idle I/O thread polls before sleeping. */
+    Clock::duration spin_duration_;
+    /** @brief I/O thread of each board, none for the first one. */
+    std::array<std::unique_ptr<Worker>, BOARD_COUNT> workers_;
+};
+
+}  // namespace solo
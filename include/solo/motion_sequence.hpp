@@ -0,0 +1,410 @@
+/**
+ * @file motion_sequence.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Scripted joint motions advanced one tick per control cycle.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <Eigen/Eigen>
+
+namespace solo
+{
+/**
+ * @brief Kind of phase of a MotionSequence.
+ */
+enum MotionPhaseKind
+{
+    /** @brief Interpolate the joints to a pose in a given duration. */
+    motion_move_to,
+    /** @brief Keep the joints at the last pose for a given duration. */
+    motion_hold,
+    /** @brief Keep the joints at the last pose until a condition holds. */
+    motion_wait_until
+};
+
+/**
+ * @brief Sequence of joint motions, e.g. stand up, sit down or park the legs,
+ * run from the control loop without blocking it.
+ *
+ * The phases are scripted once, outside the loop, in a fixed size table.
+ * step() then advances the current phase by one tick and computes the PD
+ * torques tracking it: it never blocks, allocates nor spawns a thread, so a
+ * whole routine runs at the period of the loop that calls it. SoloRobot runs
+ * a sequence in place of the user torques, see
+ * SoloRobot::start_motion_sequence().
+ *
+ * The time of the sequence is the number of ticks times a fixed control
+ * period, so a routine takes the same number of cycles whatever the clock of
+ * the loop, e.g. on an emulated or replayed robot running faster than real
+ * time.
+ *
+ * The move_to phases follow a cubic profile, with zero velocity at both
+ * ends, starting from the pose reached by the previous phase, or from the
+ * measured positions for the first one.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MAX_PHASE_COUNT Capacity of the phase table.
+ */
+template <int JOINT_COUNT, int MAX_PHASE_COUNT = 16>
+class MotionSequence
+{
+public:
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+
+    /**
+     * @brief Condition of a wait_until phase, evaluated at every tick. A
+     * plain function and a context pointer, so nothing is allocated.
+     *
+     * @param positions Measured joint positions (rad).
+     * @param velocities Measured joint velocities (rad/s).
+     * @param context Pointer given to add_wait_until().
+     */
+    typedef bool (*Condition)(const JointVector& positions,
+                              const JointVector& velocities,
+                              void* context);
+
+    /**
+     * @brief One scripted phase.
+     */
+    struct Phase
+    {
+        Phase()
+        {
+            kind = motion_hold;
+            pose.setZero();
+            duration = 0.0;
+            condition = nullptr;
+            context = nullptr;
+            label = "";
+        }
+
+        /** @brief What the phase does. */
+        MotionPhaseKind kind;
+        /** @brief Pose reached by a move_to phase (rad). */
+        JointVector pose;
+        /**
+         * @brief Duration of a move_to or hold phase, timeout of a
+         * wait_until phase, zero for none (s).
+         */
+        double duration;
+        /** @brief Condition ending a wait_until phase. */
+        Condition condition;
+        /** @brief Context of the condition. */
+        void* context;
+        /** @brief Name of the phase, a string with static lifetime. */
+        const char* label;
+    };
+
+    /**
+     * @brief Construct an empty sequence.
+     *
+     * @param kp Position gain of the tracking (Nm/rad).
+     * @param kd Velocity gain of the tracking (Nm s/rad).
+     * @param control_period Time added by every step() (s), the period of
+     * the control loop.
+     */
+    MotionSequence(double kp = 3.0,
+                   double kd = 0.05,
+                   double control_period = 0.001)
+    {
+        kp_ = kp;
+        kd_ = kd;
+        control_period_ = control_period;
+        clear();
+    }
+
+    /**
+     * @brief Remove all the phases and stop.
+     */
+    void clear()
+    {
+        phase_count_ = 0;
+        phase_index_ = 0;
+        is_running_ = false;
+        has_timed_out_ = false;
+        phase_tick_count_ = 0;
+        phase_start_pose_.setZero();
+        target_positions_.setZero();
+        target_velocities_.setZero();
+    }
+
+    /**
+     * @brief Set the tracking gains.
+     *
+     * @param kp (Nm/rad)
+     * @param kd (Nm s/rad)
+     */
+    void set_gains(double kp, double kd)
+    {
+        kp_ = kp;
+        kd_ = kd;
+    }
+
+    /**
+     * @brief Append a phase moving the joints to a pose.
+     *
+     * @param pose (rad)
+     * @param duration (s)
+     * @param label String with static lifetime.
+     * @return false if the table is full.
+     */
+    bool add_move_to(const JointVector& pose,
+                     double duration,
+                     const char* label = "move_to")
+    {
+        Phase* phase = append(motion_move_to, duration, label);
+        if (phase == nullptr)
+        {
+            return false;
+        }
+        phase->pose = pose;
+        return true;
+    }
+
+    /**
+     * @brief Append a phase keeping the joints at the last pose.
+     *
+     * @param duration (s)
+     * @param label String with static lifetime.
+     * @return false if the table is full.
+     */
+    bool add_hold(double duration, const char* label = "hold")
+    {
+        return append(motion_hold, duration, label) != nullptr;
+    }
+
+    /**
+     * @brief Append a phase keeping the joints at the last pose until a
+     * condition holds. The sequence stops and has_timed_out() is set if the
+     * condition does not hold in time.
+     *
+     * @param condition
+     * @param context Given to the condition, must outlive the sequence.
+     * @param timeout (s), zero to wait forever.
+     * @param label String with static lifetime.
+     * @return false if the table is full.
+     */
+    bool add_wait_until(Condition condition,
+                        void* context,
+                        double timeout = 0.0,
+                        const char* label = "wait_until")
+    {
+        Phase* phase = append(motion_wait_until, timeout, label);
+        if (phase == nullptr)
+        {
+            return false;
+        }
+        phase->condition = condition;
+        phase->context = context;
+        return true;
+    }
+
+    /**
+     * @brief Start the first phase.
+     *
+     * @param positions Measured joint positions (rad).
+     */
+    void start(const JointVector& positions)
+    {
+        phase_index_ = 0;
+        has_timed_out_ = false;
+        target_positions_ = positions;
+        target_velocities_.setZero();
+        is_running_ = phase_count_ > 0;
+        start_phase();
+    }
+
+    /**
+     * @brief Stop the sequence where it is.
+     */
+    void stop()
+    {
+        is_running_ = false;
+    }
+
+    /**
+     * @brief Advance the sequence by one tick and compute its torques.
+     *
+     * Every call advances the time of the sequence by the control period.
+     * Phases ending at this tick are chained within the same call.
+     *
+     * @param positions Measured joint positions (rad).
+     * @param velocities Measured joint velocities (rad/s).
+     * @param[out] torques PD torques tracking the current phase (Nm), left
+     * untouched when the sequence is not running.
+     * @return true while the sequence is running.
+     */
+    bool step(const JointVector& positions,
+              const JointVector& velocities,
+              JointVector& torques)
+    {
+        ++phase_tick_count_;
+        while (is_running_ && is_phase_done(positions, velocities))
+        {
+            if (has_timed_out_ || ++phase_index_ >= phase_count_)
+            {
+                is_running_ = false;
+                target_velocities_.setZero();
+                return false;
+            }
+            start_phase();
+        }
+        if (!is_running_)
+        {
+            return false;
+        }
+        update_targets();
+        torques = kp_ * (target_positions_ - positions) +
+                  kd_ * (target_velocities_ - velocities);
+        return true;
+    }
+
+    /** @brief If the sequence is running. */
+    bool is_running() const
+    {
+        return is_running_;
+    }
+
+    /** @brief If the last run stopped on a wait_until timeout. */
+    bool has_timed_out() const
+    {
+        return has_timed_out_;
+    }
+
+    /** @brief Index of the current phase. */
+    int get_phase_index() const
+    {
+        return phase_index_;
+    }
+
+    /** @brief Label of the current phase, empty if none. */
+    const char* get_phase_label() const
+    {
+        return phase_index_ < phase_count_ ? phases_[phase_index_].label : "";
+    }
+
+    /** @brief Number of phases. */
+    int get_phase_count() const
+    {
+        return phase_count_;
+    }
+
+    /** @brief Positions tracked at the last tick (rad). */
+    const JointVector& get_target_positions() const
+    {
+        return target_positions_;
+    }
+
+private:
+    Phase* append(MotionPhaseKind kind, double duration, const char* label)
+    {
+        if (phase_count_ >= MAX_PHASE_COUNT)
+        {
+            return nullptr;
+        }
+        Phase& phase = phases_[phase_count_++];
+        phase = Phase();
+        phase.kind = kind;
+        phase.duration = std::max(duration, 0.0);
+        phase.label = label;
+        return &phase;
+    }
+
+    /** @brief Time spent in the current phase (s). */
+    double get_phase_elapsed() const
+    {
+        return static_cast<double>(phase_tick_count_) * control_period_;
+    }
+
+    void start_phase()
+    {
+        phase_tick_count_ = 0;
+        phase_start_pose_ = target_positions_;
+    }
+
+    bool is_phase_done(const JointVector& positions,
+                       const JointVector& velocities)
+    {
+        const Phase& phase = phases_[phase_index_];
+        const double elapsed = get_phase_elapsed();
+        switch (phase.kind)
+        {
+            case motion_move_to:
+                if (elapsed >= phase.duration)
+                {
+                    // Finish exactly on the pose before chaining.
+                    target_positions_ = phase.pose;
+                    return true;
+                }
+                return false;
+
+            case motion_hold:
+                return elapsed >= phase.duration;
+
+            case motion_wait_until:
+                if (phase.condition(positions, velocities, phase.context))
+                {
+                    return true;
+                }
+                has_timed_out_ =
+                    phase.duration > 0.0 && elapsed >= phase.duration;
+                return has_timed_out_;
+        }
+        return true;
+    }
+
+    void update_targets()
+    {
+        const Phase& phase = phases_[phase_index_];
+        if (phase.kind != motion_move_to)
+        {
+            target_velocities_.setZero();
+            return;
+        }
+        // Cubic profile s(r) = 3 r^2 - 2 r^3, r in [0, 1].
+        const double r =
+            std::min(std::max(get_phase_elapsed() / phase.duration, 0.0), 1.0);
+        const double s = r * r * (3.0 - 2.0 * r);
+        const double ds = 6.0 * r * (1.0 - r) / phase.duration;
+        target_positions_ =
+            phase_start_pose_ + s * (phase.pose - phase_start_pose_);
+        target_velocities_ = ds * (phase.pose - phase_start_pose_);
+    }
+
+    /** @brief The scripted phases. */
+    std::array<Phase, MAX_PHASE_COUNT> phases_;
+    /** @brief Number of phases used. */
+    int phase_count_;
+    /** @brief Current phase. */
+    int phase_index_;
+    /** @brief If the sequence is running. */
+    bool is_running_;
+    /** @brief If a wait_until phase timed out. */
+    bool has_timed_out_;
+    /** @brief Position gain (Nm/rad). */
+    double kp_;
+    /** @brief Velocity gain (Nm s/rad). */
+    double kd_;
+    /** @brief Time added by every step() (s). */
+    double control_period_;
+    /** @brief Ticks since the start of the current phase. */
+    int64_t phase_tick_count_;
+    /** @brief Tracked pose when the current phase started (rad). */
+    JointVector phase_start_pose_;
+    /** @brief Tracked positions (rad). */
+    JointVector target_positions_;
+    /** @brief Tracked velocities (rad/s). */
+    JointVector target_velocities_;
+};
+
+}  // namespace solo
@@ -0,0 +1,256 @@
+/**
+ * @file periodic_executor.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Drift free pacing of periodic loops on absolute deadlines.
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <time.h>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#include "solo/cycle_timing.hpp"
+
+namespace solo
+{
+/**
+ * @brief What PeriodicExecutor does after a cycle overran its deadline.
+ */
+enum OverrunPolicy
+{
+    /**
+     * @brief Keep the original deadlines and run the late cycles back to back
+     * until the loop is on time again, up to max_catch_up_cycles.
+     */
+    overrun_catch_up,
+    /**
+     * @brief Drop the missed cycles and wait for the next deadline of the
+     * original grid.
+     */
+    overrun_skip
+};
+
+/**
+ * @brief Run a loop at a fixed period by sleeping to absolute deadlines.
+ *
+ * Sleeping for one period after the work makes the real period the period
+ * plus the compute time, and the loop drifts. Here the deadlines are
+ * start + k * period on CLOCK_MONOTONIC and clock_nanosleep(TIMER_ABSTIME)
+ * sleeps until the next one, so the compute time and the wake up latency
+ * never accumulate.
+ *
+ * A cycle overruns when its deadline already passed at wait(). The overruns,
+ * the missed deadlines and the wake up latency (time between a deadline and
+ * the actual wake up) are recorded. Allocation free, it can pace the real
+ * time loop.
+ *
+ * Usage:
+ * @code
+ * PeriodicExecutor executor(0.001);
+ * executor.start();
+ * while (!CTRL_C_DETECTED)
+ * {
+ *     robot.acquire_sensors();
+ *     ...
+ *     executor.wait();
+ * }
+ * @endcode
+ */
+class PeriodicExecutor
+{
+public:
+    /**
+     * @brief Construct a stopped executor.
+     *
+     * @param period_sec Period of the loop (s).
+     * @param policy Behavior after an overrun.
+     * @param max_catch_up_cycles With overrun_catch_up, number of late cycles
+     * after which the missed ones are dropped anyway.
+     */
+    PeriodicExecutor(double period_sec,
+                     OverrunPolicy policy = overrun_skip,
+                     uint64_t max_catch_up_cycles = 10)
+    {
+        if (period_sec <= 0.0)
+        {
+            throw std::runtime_error(
+                "PeriodicExecutor: the period must be positive.");
+        }
+        period_ns_ = static_cast<int64_t>(period_sec * 1e9);
+        policy_ = policy;
+        max_catch_up_cycles_ = max_catch_up_cycles;
+        next_deadline_ns_ = 0;
+        reset_statistics();
+    }
+
+    /**
+     * @brief Set the first deadline one period from now.
+     */
+    void start()
+    {
+        next_deadline_ns_ = now_ns() + period_ns_;
+    }
+
+    /**
+     * @brief Sleep until the deadline of the current cycle.
+     *
+     * Starts the executor if start() was not called.
+     *
+     * @return false if the deadline had already passed (overrun), true
+     * otherwise.
+     */
+    bool wait()
+    {
+        if (next_deadline_ns_ == 0)
+        {
+            start();
+        }
+        cycle_count_++;
+
+        int64_t now = now_ns();
+        const bool on_time = now < next_deadline_ns_;
+        if (on_time)
+        {
+            const timespec deadline = to_timespec(next_deadline_ns_);
+            while (clock_nanosleep(
+                       CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) ==
+                   EINTR)
+            {
+            }
+            now = now_ns();
+            wake_up_latency_.record(
+                static_cast<uint64_t>(now - next_deadline_ns_));
+            next_deadline_ns_ += period_ns_;
+            return true;
+        }
+
+        overrun_count_++;
+        const uint64_t late_cycles =
+            static_cast<uint64_t>((now - next_deadline_ns_) / period_ns_);
+        if (policy_ == overrun_catch_up && late_cycles < max_catch_up_cycles_)
+        {
+            // Run the next cycle right away on the original grid.
+            next_deadline_ns_ += period_ns_;
+        }
+        else
+        {
+            // Resume on the first deadline of the grid still in the future.
+            missed_deadline_count_ += late_cycles;
+            next_deadline_ns_ +=
+                static_cast<int64_t>(late_cycles + 1) * period_ns_;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Call step() once per period until stop is set.
+     *
+     * @param step Callable run at every cycle.
+     * @param stop Flag checked before every cycle.
+     */
+    template <class Step>
+    void run(Step step, const std::atomic_bool& stop)
+    {
+        start();
+        while (!stop)
+        {
+            step();
+            wait();
+        }
+    }
+
+    /**
+     * @brief Clear the overrun counters and the wake up latency histogram.
+     */
+    void reset_statistics()
+    {
+        cycle_count_ = 0;
+        overrun_count_ = 0;
+        missed_deadline_count_ = 0;
+        wake_up_latency_.reset();
+    }
+
+    /** @brief Period of the loop (s). */
+    double get_period() const
+    {
+        return static_cast<double>(period_ns_) * 1e-9;
+    }
+
+    /** @brief Behavior after an overrun. */
+    OverrunPolicy get_overrun_policy() const
+    {
+        return policy_;
+    }
+
+    /** @brief Number of calls to wait(). */
+    uint64_t get_cycle_count() const
+    {
+        return cycle_count_;
+    }
+
+    /** @brief Number of cycles that ended after their deadline. */
+    uint64_t get_overrun_count() const
+    {
+        return overrun_count_;
+    }
+
+    /** @brief Number of deadlines dropped without running a cycle. */
+    uint64_t get_missed_deadline_count() const
+    {
+        return missed_deadline_count_;
+    }
+
+    /**
+     * @brief Delay between the deadlines and the actual wake ups, for the
+     * cycles on time.
+     */
+    const LatencyHistogram& get_wake_up_latency() const
+    {
+        return wake_up_latency_;
+    }
+
+private:
+    static int64_t now_ns()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    static timespec to_timespec(int64_t time_ns)
+    {
+        timespec time;
+        time.tv_sec = static_cast<time_t>(time_ns / 1000000000);
+        time.tv_nsec = static_cast<long>(time_ns % 1000000000);
+        return time;
+    }
+
+    /** @brief Period of the loop (ns). */
+    int64_t period_ns_;
+    /** @brief Behavior after an overrun. */
+    OverrunPolicy policy_;
+    /** @brief Late cycles caught up before dropping the missed ones. */
+    uint64_t max_catch_up_cycles_;
+    /** @brief Deadline of the current cycle on CLOCK_MONOTONIC (ns), 0 when
+     * not started. */
+    int64_t next_deadline_ns_;
+
+    /** @brief Number of calls to wait(). */
+    uint64_t cycle_count_;
+    /** @brief Number of cycles that ended after their deadline. */
+    uint64_t overrun_count_;
+    /** @brief Number of deadlines dropped. */
+    uint64_t missed_deadline_count_;
+    /** @brief Delay between the deadlines and the wake ups. */
+    LatencyHistogram wake_up_latency_;
+};
+
+}  // namespace solo
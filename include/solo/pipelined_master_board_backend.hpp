@@ -0,0 +1,555 @@
+/**
+ * @file pipelined_master_board_backend.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Master board backend exchanging the packets on its own I/O thread.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "solo/master_board_backend.hpp"
+#include "solo/sensor_frame.hpp"
+#include "solo/seqlock.hpp"
+
+namespace solo
+{
+/**
+ * @brief Master board backend moving the network traffic off the control
+ * thread.
+ *
+ * It wraps another backend and owns an I/O thread which:
+ * - parses the incoming packets every parse period into a sensor frame,
+ *   published with the ready, timeout and acknowledge flags through a
+ *   SeqLock (double buffer),
+ * - transmits the latest committed command as soon as it is committed.
+ *
+ * The control thread never touches the wrapped backend during a cycle:
+ * set_torques(), set_zero_commands() and run_calibration() only stage the
+ * command, send_command() / send_init() publish it through a second SeqLock
+ * and the status getters read the published flags. The I/O thread applies
+ * the staged command to the wrapped backend right before sending it. So
+ * the master board round trip is off the critical path and the control
+ * thread cannot wait on the I/O thread.
+ *
+ * Only the configuration calls made once, outside the cycle
+ * (report_error(), set_maximum_current(), set_calibration_offsets() and
+ * restore_calibration()), are forwarded under the mutex of the wrapped
+ * backend.
+ *
+ * The flags are the ones copied by the last parse_sensor_data(), up to one
+ * parse period old, so run_calibration() reports the end of the
+ * calibration a cycle late.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+class PipelinedMasterBoardBackend
+    : public MasterBoardBackend<JOINT_COUNT, MOTOR_BOARD_COUNT>
+{
+public:
+    typedef MasterBoardBackend<JOINT_COUNT, MOTOR_BOARD_COUNT> Backend;
+    typedef typename Backend::JointVector JointVector;
+    /** @brief Sensor data published by the I/O thread. */
+    typedef SensorFrame<JOINT_COUNT, MOTOR_BOARD_COUNT> Frame;
+
+    /**
+     * @brief Wrap a backend. The I/O thread starts in init().
+     *
+     * @param backend The backend exchanging the packets.
+     * @param parse_period Period of the parsing of the incoming packets (s).
+     * @param thread_priority SCHED_FIFO priority of the I/O thread, kept at
+     * the default policy without the permissions.
+     */
+    PipelinedMasterBoardBackend(std::shared_ptr<Backend> backend,
+                                double parse_period = 0.00025,
+                                int thread_priority = 80)
+        : backend_(backend)
+    {
+        if (!backend_)
+        {
+            throw std::runtime_error(
+                "PipelinedMasterBoardBackend: no backend given.");
+        }
+        if (parse_period <= 0.0)
+        {
+            throw std::runtime_error(
+                "PipelinedMasterBoardBackend: the parse period must be "
+                "positive.");
+        }
+        parse_period_ = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(parse_period));
+        thread_priority_ = thread_priority;
+        pending_transmission_ = transmission_none;
+        running_ = false;
+        staged_command_.torques.setZero();
+        staged_command_.zero_commands = false;
+        staged_command_.run_calibration = false;
+        staged_command_.calibration_id = 0;
+        is_calibration_running_ = false;
+        completed_calibration_id_ = 0;
+    }
+
+    /**
+     * @brief Stop the I/O thread.
+     */
+    ~PipelinedMasterBoardBackend()
+    {
+        if (io_thread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(transmission_mutex_);
+                running_ = false;
+            }
+            transmission_condition_.notify_one();
+            io_thread_.join();
+        }
+    }
+
+    void init()
+    {
+        backend_->init();
+
+        // Publish a first frame so the getters are valid right away.
+        parse_and_publish();
+        running_ = true;
+        io_thread_ =
+            std::thread(&PipelinedMasterBoardBackend::io_thread_loop, this);
+        sched_param parameters;
+        parameters.sched_priority = thread_priority_;
+        pthread_setschedparam(
+            io_thread_.native_handle(), SCHED_FIFO, &parameters);
+    }
+
+    /**
+     * @brief Commit the initialization packet, sent by the I/O thread.
+     */
+    void send_init()
+    {
+        commit(transmission_init);
+    }
+
+    /**
+     * @brief Commit the staged commands, sent by the I/O thread.
+     */
+    void send_command()
+    {
+        commit(transmission_command);
+    }
+
+    /**
+     * @brief Copy the latest frame published by the I/O thread.
+     */
+    void parse_sensor_data()
+    {
+        state_publisher_.read(state_);
+    }
+
+    /**
+     * @brief If the board acknowledged the initialization, as of the last
+     * parse_sensor_data().
+     */
+    bool is_ack_msg_received()
+    {
+        return state_.is_ack_msg_received;
+    }
+
+    /**
+     * @brief If the board timed out, as of the last parse_sensor_data().
+     */
+    bool is_timeout()
+    {
+        return state_.is_timeout;
+    }
+
+    /**
+     * @brief If all the motors are ready, as of the last
+     * parse_sensor_data().
+     */
+    bool is_ready()
+    {
+        return state_.frame.is_ready;
+    }
+
+    /**
+     * @brief If an error was detected, as of the last parse_sensor_data().
+     */
+    bool has_error()
+    {
+        return state_.frame.has_error;
+    }
+
+    void report_error(const char* message)
+    {
+        std::lock_guard<std::mutex> lock(backend_mutex_);
+        backend_->report_error(message);
+    }
+
+    /**
+     * @brief Stage the torques of the next commit.
+     */
+    void set_torques(const JointVector& torques)
+    {
+        staged_command_.torques = torques;
+        staged_command_.zero_commands = false;
+    }
+
+    /**
+     * @brief Stage zero commands for the next commit.
+     */
+    void set_zero_commands()
+    {
+        staged_command_.zero_commands = true;
+    }
+
+    void set_maximum_current(double max_current)
+    {
+        std::lock_guard<std::mutex> lock(backend_mutex_);
+        backend_->set_maximum_current(max_current);
+    }
+
+    void set_calibration_offsets(const JointVector& position_offsets)
+    {
+        std::lock_guard<std::mutex> lock(backend_mutex_);
+        backend_->set_calibration_offsets(position_offsets);
+    }
+
+    /**
+     * @brief Stage one step of the calibration, run by the I/O thread before
+     * sending the next committed command.
+     *
+     * @return true once the I/O thread completed this calibration, as of
+     * the last parse_sensor_data().
+     */
+    bool run_calibration()
+    {
+        if (!is_calibration_running_)
+        {
+            is_calibration_running_ = true;
+            staged_command_.calibration_id++;
+        }
+        if (state_.completed_calibration_id == staged_command_.calibration_id)
+        {
+            is_calibration_running_ = false;
+            return true;
+        }
+        staged_command_.run_calibration = true;
+        return false;
+    }
+
+    bool restore_calibration(const JointVector& position_offsets)
+    {
+        std::lock_guard<std::mutex> lock(backend_mutex_);
+        return backend_->restore_calibration(position_offsets);
+    }
+
+    const JointVector& get_joint_positions() const
+    {
+        return state_.frame.joint_positions;
+    }
+    const JointVector& get_joint_velocities() const
+    {
+        return state_.frame.joint_velocities;
+    }
+    const JointVector& get_joint_measured_torques() const
+    {
+        return state_.frame.joint_torques;
+    }
+    const JointVector& get_joint_sent_torques() const
+    {
+        return state_.frame.joint_target_torques;
+    }
+    const Eigen::Vector3d& get_imu_accelerometer() const
+    {
+        return state_.frame.imu_accelerometer;
+    }
+    const Eigen::Vector3d& get_imu_gyroscope() const
+    {
+        return state_.frame.imu_gyroscope;
+    }
+    const Eigen::Vector3d& get_imu_attitude() const
+    {
+        return state_.frame.imu_attitude;
+    }
+    const Eigen::Vector3d& get_imu_linear_acceleration() const
+    {
+        return state_.frame.imu_linear_acceleration;
+    }
+    const Eigen::Vector4d& get_imu_attitude_quaternion() const
+    {
+        return state_.frame.imu_attitude_quaternion;
+    }
+    const std::array<bool, JOINT_COUNT>& get_motor_enabled() const
+    {
+        return state_.frame.motor_enabled;
+    }
+    const std::array<bool, JOINT_COUNT>& get_motor_ready() const
+    {
+        return state_.frame.motor_ready;
+    }
+    const std::array<bool, MOTOR_BOARD_COUNT>& get_motor_board_enabled() const
+    {
+        return state_.frame.motor_board_enabled;
+    }
+    const std::array<int, MOTOR_BOARD_COUNT>& get_motor_board_errors() const
+    {
+        return state_.frame.motor_board_errors;
+    }
+
+    /**
+     * @brief Age of the frame copied by the last parse_sensor_data().
+     *
+     * @return double (s)
+     */
+    double get_frame_age() const
+    {
+        return Frame::now() - state_.frame.timestamp;
+    }
+
+    /**
+     * @brief Number of frames published by the I/O thread so far.
+     */
+    uint64_t get_frame_count() const
+    {
+        return state_publisher_.get_version();
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /** @brief Packet to send at the next wake up of the I/O thread. */
+    enum Transmission
+    {
+        transmission_none,
+        transmission_init,
+        transmission_command
+    };
+
+    /**
+     * @brief Command staged by the control thread.
+     */
+    struct Command
+    {
+        /** @brief Torques of the joints (Nm). */
+        JointVector torques;
+        /** @brief Send zero commands instead of the torques. */
+        bool zero_commands;
+        /** @brief Run one calibration step before sending. */
+        bool run_calibration;
+        /**
+         * @brief Calibration the step belongs to, no step is run once it
+         * completed.
+         */
+        uint64_t calibration_id;
+    };
+
+    /**
+     * @brief What the I/O thread publishes.
+     */
+    struct State
+    {
+        State()
+        {
+            is_timeout = false;
+            is_ack_msg_received = false;
+            completed_calibration_id = 0;
+        }
+
+        /** @brief The sensor data. */
+        Frame frame;
+        /** @brief If the board timed out. */
+        bool is_timeout;
+        /** @brief If the board acknowledged the initialization. */
+        bool is_ack_msg_received;
+        /** @brief Last calibration completed. */
+        uint64_t completed_calibration_id;
+    };
+
+    /**
+     * @brief Hand the packet to the I/O thread, the latest commit wins.
+     *
+     * The transmission mutex is only held by either thread to swap the
+     * pending packet, never during an exchange with the board.
+     */
+    void commit(Transmission transmission)
+    {
+        command_publisher_.write(staged_command_);
+        staged_command_.run_calibration = false;
+        {
+            std::lock_guard<std::mutex> lock(transmission_mutex_);
+            pending_transmission_ = transmission;
+        }
+        transmission_condition_.notify_one();
+    }
+
+    /**
+     * @brief Parse the incoming packet and publish the resulting frame.
+     */
+    void parse_and_publish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(backend_mutex_);
+            backend_->parse_sensor_data();
+            io_frame_.joint_positions = backend_->get_joint_positions();
+            io_frame_.joint_velocities = backend_->get_joint_velocities();
+            io_frame_.joint_torques = backend_->get_joint_measured_torques();
+            io_frame_.joint_target_torques =
+                backend_->get_joint_sent_torques();
+            io_frame_.imu_accelerometer = backend_->get_imu_accelerometer();
+            io_frame_.imu_gyroscope = backend_->get_imu_gyroscope();
+            io_frame_.imu_attitude = backend_->get_imu_attitude();
+            io_frame_.imu_linear_acceleration =
+                backend_->get_imu_linear_acceleration();
+            io_frame_.imu_attitude_quaternion =
+                backend_->get_imu_attitude_quaternion();
+            io_frame_.motor_enabled = backend_->get_motor_enabled();
+            io_frame_.motor_ready = backend_->get_motor_ready();
+            io_frame_.motor_board_enabled =
+                backend_->get_motor_board_enabled();
+            io_frame_.motor_board_errors = backend_->get_motor_board_errors();
+            io_frame_.is_ready = backend_->is_ready();
+            io_frame_.has_error = backend_->has_error();
+            io_state_.is_timeout = backend_->is_timeout();
+            io_state_.is_ack_msg_received = backend_->is_ack_msg_received();
+        }
+        io_frame_.cycle++;
+        io_frame_.timestamp = Frame::now();
+        io_state_.frame = io_frame_;
+        io_state_.completed_calibration_id = completed_calibration_id_;
+        state_publisher_.write(io_state_);
+    }
+
+    /**
+     * @brief Apply the latest committed command to the wrapped backend and
+     * send it.
+     */
+    void transmit(Transmission transmission)
+    {
+        command_publisher_.read(io_command_);
+        std::lock_guard<std::mutex> lock(backend_mutex_);
+        if (io_command_.zero_commands)
+        {
+            backend_->set_zero_commands();
+        }
+        else
+        {
+            backend_->set_torques(io_command_.torques);
+        }
+        if (io_command_.run_calibration &&
+            io_command_.calibration_id != completed_calibration_id_ &&
+            backend_->run_calibration())
+        {
+            completed_calibration_id_ = io_command_.calibration_id;
+        }
+        if (transmission == transmission_init)
+        {
+            backend_->send_init();
+        }
+        else
+        {
+            backend_->send_command();
+        }
+    }
+
+    /**
+     * @brief Body of the I/O thread.
+     */
+    void io_thread_loop()
+    {
+        Clock::time_point next_parse = Clock::now() + parse_period_;
+        while (true)
+        {
+            Transmission transmission;
+            {
+                std::unique_lock<std::mutex> lock(transmission_mutex_);
+                transmission_condition_.wait_until(lock, next_parse, [this]() {
+                    return pending_transmission_ != transmission_none ||
+                           !running_;
+                });
+                if (!running_)
+                {
+                    return;
+                }
+                transmission = pending_transmission_;
+                pending_transmission_ = transmission_none;
+            }
+
+            if (transmission != transmission_none)
+            {
+                transmit(transmission);
+            }
+
+            const Clock::time_point now = Clock::now();
+            if (now >= next_parse)
+            {
+                parse_and_publish();
+                next_parse += parse_period_;
+                if (next_parse < now)
+                {
+                    // Skip the missed periods rather than bursting.
+                    next_parse = now + parse_period_;
+                }
+            }
+        }
+    }
+
+    /** @brief The backend exchanging the packets. */
+    std::shared_ptr<Backend> backend_;
+    /**
+     * @brief Serializes the calls to backend_ of the I/O thread and of the
+     * configuration calls.
+     */
+    std::mutex backend_mutex_;
+
+    /** @brief Period of the parsing of the incoming packets. */
+    Clock::duration parse_period_;
+    /** @brief SCHED_FIFO priority of the I/O thread. */
+    int thread_priority_;
+    /** @brief The I/O thread. */
+    std::thread io_thread_;
+
+    /** @brief Packet committed by the control thread. */
+    Transmission pending_transmission_;
+    /** @brief Cleared to stop the I/O thread. */
+    bool running_;
+    /** @brief Protects pending_transmission_ and running_. */
+    std::mutex transmission_mutex_;
+    /** @brief Wakes the I/O thread up on a commit. */
+    std::condition_variable transmission_condition_;
+
+    /** @brief Command staged by the control thread. */
+    Command staged_command_;
+    /** @brief Latest command committed by the control thread. */
+    SeqLock<Command> command_publisher_;
+    /** @brief Command copied by the I/O thread. */
+    Command io_command_;
+    /** @brief If run_calibration() was called since the last completion. */
+    bool is_calibration_running_;
+    /** @brief Last calibration completed by the I/O thread. */
+    uint64_t completed_calibration_id_;
+
+    /** @brief Frame filled by the I/O thread. */
+    Frame io_frame_;
+    /** @brief State filled by the I/O thread. */
+    State io_state_;
+    /** @brief Latest state published by the I/O thread. */
+    SeqLock<State> state_publisher_;
+    /** @brief State copied by the control thread. */
+    State state_;
+};
+
+}  // namespace solo
@@ -0,0 +1,305 @@
+/**
+ * @file rt_logger.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Logging from the real time loops without formatting nor I/O.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include <Eigen/Eigen>
+
+#include "solo/spsc_ring.hpp"
+
+namespace solo
+{
+/**
+ * @brief Kind of entry logged by RtLogger.
+ */
+enum RtLogKind
+{
+    /** @brief The label alone. */
+    rt_log_message,
+    /** @brief The label and one value. */
+    rt_log_value,
+    /** @brief The label and a vector. */
+    rt_log_vector
+};
+
+/**
+ * @brief Binary log entry queued by the real time thread.
+ *
+ * The label is not copied: it must outlive the logger, e.g. a string literal.
+ */
+struct RtLogRecord
+{
+    /** @brief Maximum number of values of a vector entry. */
+    static constexpr int max_value_count = 24;
+
+    RtLogRecord()
+    {
+        kind = rt_log_message;
+        label = "";
+        timestamp = 0.0;
+        value_count = 0;
+        truncated = false;
+        values.fill(0.0);
+    }
+
+    /** @brief Kind of entry. */
+    RtLogKind kind;
+    /** @brief Identifier of the entry, a string with static lifetime. */
+    const char* label;
+    /** @brief Monotonic time of the entry (s). */
+    double timestamp;
+    /** @brief Number of values used. */
+    int value_count;
+    /** @brief If the vector had more than max_value_count values. */
+    bool truncated;
+    /** @brief The values. */
+    std::array<double, max_value_count> values;
+};
+
+/**
+ * @brief Asynchronous logger for the real time loops.
+ *
+ * The real time thread only copies a fixed size binary record into a
+ * preallocated SpscRing: no formatting, no allocation, no system call. A
+ * background thread drains the ring, formats the records and writes them to
+ * the output stream. When the ring is full the records are dropped and
+ * counted instead of blocking the loop.
+ *
+ * All the log functions must be called from the same thread, the single
+ * producer of the ring.
+ */
+class RtLogger
+{
+public:
+    /**
+     * @brief Start the writer thread.
+     *
+     * @param capacity Number of records the ring holds (power of two).
+     * @param stream Output of the writer thread.
+     * @param drain_period Period at which the ring is drained (s).
+     */
+    RtLogger(std::size_t capacity = 1024,
+             FILE* stream = stdout,
+             double drain_period = 0.005)
+        : queue_(capacity), dropped_count_(0), is_running_(true)
+    {
+        stream_ = stream;
+        drain_period_ = drain_period;
+        reported_dropped_count_ = 0;
+        writer_thread_ = std::thread(&RtLogger::writer_loop, this);
+    }
+
+    /**
+     * @brief Write the queued records and stop the writer thread.
+     */
+    ~RtLogger()
+    {
+        stop();
+    }
+
+    RtLogger(const RtLogger&) = delete;
+    RtLogger& operator=(const RtLogger&) = delete;
+
+    /**
+     * @brief Log a message.
+     *
+     * @param label String with static lifetime.
+     * @return false if the record was dropped.
+     */
+    bool log_message(const char* label)
+    {
+        record_.kind = rt_log_message;
+        record_.label = label;
+        record_.value_count = 0;
+        record_.truncated = false;
+        return push();
+    }
+
+    /**
+     * @brief Log a single value.
+     *
+     * @param label String with static lifetime.
+     * @param value
+     * @return false if the record was dropped.
+     */
+    bool log_value(const char* label, double value)
+    {
+        record_.kind = rt_log_value;
+        record_.label = label;
+        record_.value_count = 1;
+        record_.truncated = false;
+        record_.values[0] = value;
+        return push();
+    }
+
+    /**
+     * @brief Log a vector. Only the first RtLogRecord::max_value_count values
+     * are kept.
+     *
+     * Taking any Eigen expression, e.g. `-robot.get_joint_positions()`, the
+     * coefficients are copied without evaluating a temporary vector.
+     *
+     * @param label String with static lifetime.
+     * @param vector
+     * @return false if the record was dropped.
+     */
+    template <class Derived>
+    bool log_vector(const char* label, const Eigen::MatrixBase<Derived>& vector)
+    {
+        const int size = static_cast<int>(vector.size());
+        record_.kind = rt_log_vector;
+        record_.label = label;
+        record_.truncated = size > RtLogRecord::max_value_count;
+        record_.value_count =
+            record_.truncated ? RtLogRecord::max_value_count : size;
+        for (int i = 0; i < record_.value_count; ++i)
+        {
+            record_.values[i] = vector(i);
+        }
+        return push();
+    }
+
+    /**
+     * @brief Write the queued records and stop the writer thread. Further
+     * records are dropped.
+     */
+    void stop()
+    {
+        if (!is_running_.exchange(false))
+        {
+            return;
+        }
+        writer_thread_.join();
+        drain_queue();
+    }
+
+    /**
+     * @brief Number of records dropped because the ring was full.
+     */
+    uint64_t get_dropped_count() const
+    {
+        return dropped_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Timestamp and queue the staged record.
+     */
+    bool push()
+    {
+        record_.timestamp =
+            std::chrono::duration<double>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        if (!is_running_.load(std::memory_order_relaxed) ||
+            !queue_.push(record_))
+        {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Background thread: periodically format the queued records.
+     */
+    void writer_loop()
+    {
+        while (is_running_.load())
+        {
+            drain_queue();
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(drain_period_));
+        }
+    }
+
+    /**
+     * @brief Format and write all the queued records.
+     */
+    void drain_queue()
+    {
+        bool written = false;
+        while (queue_.pop(pending_record_))
+        {
+            write(pending_record_);
+            written = true;
+        }
+        const uint64_t dropped_count = get_dropped_count();
+        if (dropped_count != reported_dropped_count_)
+        {
+            std::fprintf(stream_,
+                         "RtLogger: %lu records dropped.\n",
+                         (unsigned long)(dropped_count -
+                                         reported_dropped_count_));
+            reported_dropped_count_ = dropped_count;
+            written = true;
+        }
+        if (written)
+        {
+            std::fflush(stream_);
+        }
+    }
+
+    /**
+     * @brief Format one record, like the former print_vector().
+     */
+    void write(const RtLogRecord& record)
+    {
+        switch (record.kind)
+        {
+            case rt_log_message:
+                std::fprintf(stream_, "%s\n", record.label);
+                break;
+
+            case rt_log_value:
+                std::fprintf(
+                    stream_, "%s: %0.3f\n", record.label, record.values[0]);
+                break;
+
+            case rt_log_vector:
+                std::fprintf(stream_, "%s: [", record.label);
+                for (int i = 0; i < record.value_count; ++i)
+                {
+                    std::fprintf(stream_, "%0.3f, ", record.values[i]);
+                }
+                std::fprintf(stream_, record.truncated ? "...]\n" : "]\n");
+                break;
+        }
+    }
+
+    /** @brief Queue between the real time thread and the writer. */
+    SpscRing<RtLogRecord> queue_;
+    /** @brief Record staged by the real time thread. */
+    RtLogRecord record_;
+    /** @brief Record being formatted by the writer thread. */
+    RtLogRecord pending_record_;
+
+    /** @brief Output of the writer thread. */
+    FILE* stream_;
+    /** @brief Period at which the ring is drained (s). */
+    double drain_period_;
+    /** @brief Number of records dropped. */
+    std::atomic<uint64_t> dropped_count_;
+    /** @brief Dropped records already reported, writer thread only. */
+    uint64_t reported_dropped_count_;
+    /** @brief Cleared to stop the writer thread. */
+    std::atomic_bool is_running_;
+    /** @brief The writer thread. */
+    std::thread writer_thread_;
+};
+
+}  // namespace solo
@@ -0,0 +1,138 @@
+/**
+ * @file sensor_frame.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Complete set of sensor data acquired during one control cycle.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include <Eigen/Eigen>
+
+namespace solo
+{
+/**
+ * @brief All the sensor data acquired in one call to acquire_sensors().
+ *
+ * The robot classes publish one frame per cycle through a SeqLock so that
+ * monitoring threads can read a consistent copy without ever blocking the
+ * control loop. Fields a robot does not have (e.g. the imu on Solo8TI) keep
+ * their default value.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+struct SensorFrame
+{
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+
+    SensorFrame()
+    {
+        cycle = 0;
+        timestamp = 0.0;
+        joint_positions.setZero();
+        joint_velocities.setZero();
+        joint_torques.setZero();
+        joint_target_torques.setZero();
+        joint_encoder_index.setZero();
+        slider_positions.setZero();
+        contact_sensors_states.setZero();
+        imu_accelerometer.setZero();
+        imu_gyroscope.setZero();
+        imu_attitude.setZero();
+        imu_linear_acceleration.setZero();
+        imu_attitude_quaternion << 0.0, 0.0, 0.0, 1.0;
+        motor_enabled.fill(false);
+        motor_ready.fill(false);
+        motor_board_enabled.fill(false);
+        motor_board_errors.fill(0);
+        active_estop = false;
+        is_ready = false;
+        is_calibrating = false;
+        has_error = false;
+    }
+
+    /**
+     * @brief Get the current time in the clock used for the frame timestamps.
+     *
+     * @return double (s) Monotonic time.
+     */
+    static double now()
+    {
+        return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /** @brief Index of the acquisition cycle, starts at 1. */
+    uint64_t cycle;
+    /** @brief Monotonic time of the acquisition (s), see now(). */
+    double timestamp;
+
+    /*
+     * Joint data
+     */
+
+    /** @brief Joint positions (rad). */
+    JointVector joint_positions;
+    /** @brief Joint velocities (rad/s). */
+    JointVector joint_velocities;
+    /** @brief Measured joint torques (Nm). */
+    JointVector joint_torques;
+    /** @brief Joint torques sent to the motors (Nm). */
+    JointVector joint_target_torques;
+    /** @brief Position of the encoder indexes (rad). */
+    JointVector joint_encoder_index;
+
+    /*
+     * Additional data
+     */
+
+    /** @brief Slider positions in [0, 1]. */
+    Eigen::Vector4d slider_positions;
+    /** @brief Contact sensor states. */
+    Eigen::Vector4d contact_sensors_states;
+    /** @brief Base accelerometer. */
+    Eigen::Vector3d imu_accelerometer;
+    /** @brief Base gyroscope. */
+    Eigen::Vector3d imu_gyroscope;
+    /** @brief Base attitude (euler angles). */
+    Eigen::Vector3d imu_attitude;
+    /** @brief Base linear acceleration. */
+    Eigen::Vector3d imu_linear_acceleration;
+    /** @brief Base attitude quaternion ordered {x, y, z, w}. */
+    Eigen::Vector4d imu_attitude_quaternion;
+
+    /*
+     * Hardware status
+     */
+
+    /** @brief Enabled status of each motor (joint ordering). */
+    std::array<bool, JOINT_COUNT> motor_enabled;
+    /** @brief Ready status of each motor (joint ordering). */
+    std::array<bool, JOINT_COUNT> motor_ready;
+    /** @brief Enabled status of each motor board. */
+    std::array<bool, MOTOR_BOARD_COUNT> motor_board_enabled;
+    /** @brief Error code of each motor board. */
+    std::array<int, MOTOR_BOARD_COUNT> motor_board_errors;
+
+    /** @brief If the soft estop is active. */
+    bool active_estop;
+    /** @brief If the robot is ready to be controlled. */
+    bool is_ready;
+    /** @brief If the joint calibration is running. */
+    bool is_calibrating;
+    /** @brief If the hardware reports an error. */
+    bool has_error;
+};
+
+}  // namespace solo
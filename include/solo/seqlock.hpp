@@ -0,0 +1,121 @@
+/**
+ * @file seqlock.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Single writer, multiple readers sequence lock.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace solo
+{
+/**
+ * @brief Publish a value from one (real time) writer thread to any number of
+ * reader threads without locks.
+ *
+ * The writer never waits: it bumps the sequence to an odd number, copies the
+ * value and bumps the sequence to the next even number. A reader copies the
+ * value and retries if the sequence changed or was odd in the meantime, so a
+ * slow or preempted reader can never delay the writer. Readers only retry
+ * while a write overlaps their copy, which for a 1kHz writer is rare.
+ *
+ * Only one thread may call write().
+ *
+ * @tparam T Type of the published value. It must be copy assignable and
+ * default constructible.
+ */
+template <class T>
+class SeqLock
+{
+public:
+    /**
+     * @brief Construct with a default constructed value and version 0.
+     */
+    SeqLock() : sequence_(0)
+    {
+    }
+
+    /**
+     * @brief Publish a new value. Wait free, never blocks.
+     *
+     * @param value
+     */
+    void write(const T& value)
+    {
+        const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value_ = value;
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Try to copy the latest published value once.
+     *
+     * @param[out] value Copy of the latest value, only valid on success.
+     * @return true if the copy is consistent, false if a write overlapped.
+     */
+    bool try_read(T& value) const
+    {
+        const uint64_t sequence_before =
+            sequence_.load(std::memory_order_acquire);
+        if (sequence_before & 1)
+        {
+            return false;
+        }
+        value = value_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t sequence_after =
+            sequence_.load(std::memory_order_relaxed);
+        return sequence_before == sequence_after;
+    }
+
+    /**
+     * @brief Copy the latest published value, retrying until the copy is
+     * consistent.
+     *
+     * @param[out] value Copy of the latest value.
+     * @return uint64_t The version of the copied value, see get_version().
+     */
+    uint64_t read(T& value) const
+    {
+        while (true)
+        {
+            const uint64_t sequence_before =
+                sequence_.load(std::memory_order_acquire);
+            if (sequence_before & 1)
+            {
+                continue;
+            }
+            value = value_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_before == sequence_.load(std::memory_order_relaxed))
+            {
+                return sequence_before / 2;
+            }
+        }
+    }
+
+    /**
+     * @brief Number of values published so far.
+     */
+    uint64_t get_version() const
+    {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    /** @brief Odd while a write is in progress, twice the version else. */
+    std::atomic<uint64_t> sequence_;
+
+    /** @brief The published value. */
+    T value_;
+};
+
+}  // namespace solo
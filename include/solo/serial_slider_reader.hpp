@@ -0,0 +1,336 @@
+/**
+ * @file serial_slider_reader.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Background reader of the slider box serial port.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "solo/seqlock.hpp"
+
+namespace solo
+{
+/**
+ * @brief One frame of the slider box.
+ *
+ * @tparam VALUE_COUNT Number of integers per frame.
+ */
+template <int VALUE_COUNT>
+struct SerialSample
+{
+    SerialSample()
+    {
+        values.fill(0);
+        timestamp = 0.0;
+        count = 0;
+    }
+
+    /** @brief Raw values of the frame, in the order they were sent. */
+    std::array<int, VALUE_COUNT> values;
+    /** @brief Monotonic time at which the frame was received (s), see
+     * SerialSliderReader::now(). Time the reader started if count is 0. */
+    double timestamp;
+    /** @brief Number of frames received so far, 0 if none. */
+    uint64_t count;
+};
+
+/**
+ * @brief What to do when the slider box stops sending.
+ */
+struct SliderStalenessPolicy
+{
+    SliderStalenessPolicy()
+    {
+        max_age = 0.1;
+        startup_timeout = 3.0;
+        trigger_estop = true;
+    }
+
+    /** @brief Age above which the slider data is stale (s). */
+    double max_age;
+    /** @brief Delay allowed for the first frame, the arduino reboots when
+     * the port is opened (s). */
+    double startup_timeout;
+    /** @brief If stale slider data activates the soft E-Stop. */
+    bool trigger_estop;
+};
+
+/**
+ * @brief Read the frames of the slider box on a dedicated thread.
+ *
+ * The arduino of the slider box sends lines of space separated integers, the
+ * first one being the E-Stop button state followed by the slider values. A
+ * background thread parses them, timestamps them on arrival and publishes
+ * the latest complete frame through a SeqLock, so the control loop only pays
+ * for a copy and can tell from the timestamp how old the data is. Malformed
+ * lines are counted and dropped.
+ *
+ * @tparam VALUE_COUNT Number of integers per frame.
+ */
+template <int VALUE_COUNT>
+class SerialSliderReader
+{
+public:
+    /** @brief Frame type published by the reader. */
+    typedef SerialSample<VALUE_COUNT> Sample;
+
+    /**
+     * @brief Open the serial port and start the reader thread.
+     *
+     * If the port cannot be opened, /dev/ttyACM0 to /dev/ttyACM9 are tried
+     * like blmc_drivers::SerialReader does. If none can be opened the reader
+     * never publishes a frame, which the staleness policy detects.
+     *
+     * @param serial_port Device of the slider box, e.g. /dev/ttyACM0.
+     */
+    SerialSliderReader(const std::string& serial_port)
+        : file_descriptor_(-1),
+          running_(true),
+          parse_error_count_(0),
+          line_size_(0)
+    {
+        Sample sample;
+        sample.timestamp = now();
+        sample_publisher_.write(sample);
+
+        if (!open_port(serial_port))
+        {
+            for (int i = 0; i < 10 && file_descriptor_ < 0; ++i)
+            {
+                open_port("/dev/ttyACM" + std::to_string(i));
+            }
+        }
+        if (file_descriptor_ < 0)
+        {
+            std::fprintf(stderr,
+                         "SerialSliderReader: cannot open %s nor any "
+                         "/dev/ttyACM*, no slider data will be received.\n",
+                         serial_port.c_str());
+            return;
+        }
+        reader_thread_ = std::thread(&SerialSliderReader::reader_loop, this);
+    }
+
+    /**
+     * @brief Stop the reader thread and close the port.
+     */
+    ~SerialSliderReader()
+    {
+        running_ = false;
+        if (reader_thread_.joinable())
+        {
+            reader_thread_.join();
+        }
+        if (file_descriptor_ >= 0)
+        {
+            ::close(file_descriptor_);
+        }
+    }
+
+    SerialSliderReader(const SerialSliderReader&) = delete;
+    SerialSliderReader& operator=(const SerialSliderReader&) = delete;
+
+    /**
+     * @brief Get the current time in the clock of the sample timestamps.
+     *
+     * @return double (s) Monotonic time.
+     */
+    static double now()
+    {
+        return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief Copy the latest frame. Never blocks the reader thread.
+     *
+     * @param[out] sample
+     * @return uint64_t The number of frames received so far.
+     */
+    uint64_t read(Sample& sample) const
+    {
+        sample_publisher_.read(sample);
+        return sample.count;
+    }
+
+    /**
+     * @brief If a serial port could be opened.
+     */
+    bool is_connected() const
+    {
+        return file_descriptor_ >= 0;
+    }
+
+    /**
+     * @brief Get the serial port in use, empty if none could be opened.
+     */
+    const std::string& get_port() const
+    {
+        return port_;
+    }
+
+    /**
+     * @brief Number of lines dropped because they were malformed.
+     */
+    uint64_t get_parse_error_count() const
+    {
+        return parse_error_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Open and configure a serial port at 115200 baud, raw mode.
+     *
+     * @return true on success.
+     */
+    bool open_port(const std::string& serial_port)
+    {
+        int file_descriptor = ::open(serial_port.c_str(), O_RDWR | O_NOCTTY);
+        if (file_descriptor < 0)
+        {
+            return false;
+        }
+        struct termios options;
+        if (::tcgetattr(file_descriptor, &options) != 0)
+        {
+            ::close(file_descriptor);
+            return false;
+        }
+        ::cfmakeraw(&options);
+        ::cfsetispeed(&options, B115200);
+        ::cfsetospeed(&options, B115200);
+        options.c_cflag |= CLOCAL | CREAD;
+        // Return after at most 100ms so that the thread can be stopped.
+        options.c_cc[VMIN] = 0;
+        options.c_cc[VTIME] = 1;
+        if (::tcsetattr(file_descriptor, TCSANOW, &options) != 0)
+        {
+            ::close(file_descriptor);
+            return false;
+        }
+        ::tcflush(file_descriptor, TCIFLUSH);
+        file_descriptor_ = file_descriptor;
+        port_ = serial_port;
+        return true;
+    }
+
+    /**
+     * @brief Background thread: split the stream into lines and parse them.
+     */
+    void reader_loop()
+    {
+        char buffer[256];
+        while (running_)
+        {
+            const ssize_t size =
+                ::read(file_descriptor_, buffer, sizeof(buffer));
+            // Take the timestamp as close as possible to the reception.
+            const double timestamp = now();
+            for (ssize_t i = 0; i < size; ++i)
+            {
+                const char character = buffer[i];
+                if (character == '\n' || character == '\r')
+                {
+                    if (line_size_ > 0)
+                    {
+                        line_[line_size_] = '\0';
+                        parse_line(timestamp);
+                    }
+                    line_size_ = 0;
+                }
+                else if (line_size_ + 1 < line_.size())
+                {
+                    line_[line_size_++] = character;
+                }
+                else
+                {
+                    // Line too long, drop it.
+                    parse_error_count_.fetch_add(1, std::memory_order_relaxed);
+                    line_size_ = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Publish the current line if it holds exactly VALUE_COUNT
+     * integers.
+     */
+    void parse_line(double timestamp)
+    {
+        const char* position = line_.data();
+        char* end = nullptr;
+        int value_count = 0;
+        while (true)
+        {
+            const long value = std::strtol(position, &end, 10);
+            if (end == position)
+            {
+                break;
+            }
+            if (value_count < VALUE_COUNT)
+            {
+                sample_.values[value_count] = static_cast<int>(value);
+            }
+            ++value_count;
+            position = end;
+        }
+        // Only trailing blanks may remain.
+        while (*position == ' ' || *position == '\t')
+        {
+            ++position;
+        }
+        if (value_count != VALUE_COUNT || *position != '\0')
+        {
+            parse_error_count_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        sample_.timestamp = timestamp;
+        sample_.count++;
+        sample_publisher_.write(sample_);
+    }
+
+    /** @brief File descriptor of the serial port, -1 if none. */
+    int file_descriptor_;
+    /** @brief Serial port in use. */
+    std::string port_;
+    /** @brief Set to false to stop the reader thread. */
+    std::atomic<bool> running_;
+    /** @brief Number of malformed lines. */
+    std::atomic<uint64_t> parse_error_count_;
+    /** @brief Line being received. */
+    std::array<char, 128> line_;
+    /** @brief Number of characters in line_. */
+    std::size_t line_size_;
+    /** @brief Frame being parsed, owned by the reader thread. */
+    Sample sample_;
+    /** @brief Lock free publisher of the latest frame. */
+    SeqLock<Sample> sample_publisher_;
+    /** @brief Thread reading the serial port. */
+    std::thread reader_thread_;
+};
+
+/**
+ * @brief Reader of the slider box: the E-Stop state followed by 4 sliders.
+ */
+typedef SerialSliderReader<5> SliderBoxReader;
+
+}  // namespace solo
@@ -8,22 +8,12 @@
 
 #pragma once
 
-#include <blmc_drivers/serial_reader.hpp>
-#include <odri_control_interface/calibration.hpp>
-#include <odri_control_interface/robot.hpp>
-#include "solo/common_header.hpp"
+#include "solo/solo_robot.hpp"
 
 namespace solo
 {
-enum Solo12State
-{
-    initial,
-    ready,
-    calibrate
-};
-
 /**
- * @brief Definition and drivers for the Solo12 robot.
+ * @brief Definition of the Solo12 robot.
  *
  * Mapping between the DOF and driver boards + motor ports:
  * FL_HAA - motor board 0, motor port 0, motor index 0
@@ -39,475 +29,113 @@ enum Solo12State
  * HR_HFE - motor board 5, motor port 1, motor index 11
  * HR_KFE - motor board 5, motor port 0, motor index 10
  */
-class Solo12
+struct Solo12Traits
 {
-public:
-    /**
-     * @brief Solo is the constructor of the class.
-     */
-    Solo12();
-
-    /**
-     * @brief Initialize the robot by setting aligning the motors and calibrate
-     * the sensors to 0.
-     * @param if_name Interface for connection to hardware.
-     */
-    void initialize(const std::string& network_id,
-                    const std::string& serial_port);
-
-    /**
-     * @brief Sets the maximum joint torques.
-     */
-    void set_max_current(const double& max_current);
-
-    /**
-     * @brief Wait that the robot enters into the ready states.
-     */
-    void wait_until_ready();
-
-    /**
-     * @brief Check if the robot is ready.
-     */
-    bool is_ready();
-
-    /**
-     * @brief send_target_torques sends the target currents to the motors.
-     */
-    void send_target_joint_torque(
-        const Eigen::Ref<Vector12d> target_joint_torque);
-
-    /**
-     * @brief acquire_sensors acquire all available sensors, WARNING !!!!
-     * this method has to be called prior to any getter to have up to date data.
-     */
-    void acquire_sensors();
-
-    /**
-     * @brief Asynchronously request for the calibration.
-     *
-     * @param home_offset_rad This is the angle between the index and the zero
-     * pose.
-     * @return true in case of success.
-     * @return false in case of failure.
-     */
-    bool request_calibration(const Vector12d& home_offset_rad);
-
-    /**
-     * Joint properties
-     */
-
-    /**
-     * @brief get_motor_inertias in [kg m^2]
-     * @return Motor inertias.
-     */
-    const Eigen::Ref<Vector12d> get_motor_inertias()
-    {
-        return motor_inertias_;
-    }
-
-    /**
-     * @brief get_motor_torque_constants in []
-     * @return Torque constants of each motor.
-     */
-    const Eigen::Ref<Vector12d> get_motor_torque_constants()
-    {
-        return motor_torque_constants_;
-    }
-
-    /**
-     * @brief get_joint_gear_ratios
-     * @return Joint gear ratios
-     */
-    const Eigen::Ref<Vector12d> get_joint_gear_ratios()
-    {
-        return joint_gear_ratios_;
-    }
-
-    /**
-     * @brief get_max_torque
-     * @return the max torque that has been hardcoded in the constructor of this
-     * class. @todo Parametrize the maximum current via yaml or something else.
-     */
-    const Eigen::Ref<Vector12d> get_motor_max_current()
-    {
-        return motor_max_current_;
-    }
-
-    /**
-     * Sensor Data
-     */
-
-    /**
-     * @brief get_joint_positions
-     * @return  the joint angle of each module
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector12d> get_joint_positions()
-    {
-        return joint_positions_;
-    }
-
-    /**
-     * @brief get_joint_velocities
-     * @return the joint velocities
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector12d> get_joint_velocities()
-    {
-        return joint_velocities_;
-    }
-
-    /**
-     * @brief get_joint_torques
-     * @return the joint torques
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector12d> get_joint_torques()
-    {
-        return joint_torques_;
-    }
-
-    /**
-     * @brief get_joint_torques
-     * @return the target joint torques
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector12d> get_joint_target_torques()
-    {
-        return joint_target_torques_;
-    }
-
-    /**
-     * @brief get_joint_encoder_index
-     * @return the position of the index of the encoders a the motor level
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector12d> get_joint_encoder_index()
-    {
-        return joint_encoder_index_;
-    }
-
-    /*
-     * Additional data
-     */
-
-    /**
-     * @brief get_contact_sensors_states
-     * @return the state of the contacts states
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector4d> get_contact_sensors_states()
-    {
-        return contact_sensors_states_;
-    }
-
-    /**
-     * @brief get_slider_positions
-     * @return the current sliders positions.
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector4d> get_slider_positions()
-    {
-        return slider_positions_;
-    }
-
-    /** @brief base accelerometer from imu.
-     * @return
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector3d> get_imu_accelerometer()
-    {
-        return imu_accelerometer_;
-    }
-
-    /** @brief base gyroscope from imu.
-     * @return
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector3d> get_imu_gyroscope()
-    {
-        return imu_gyroscope_;
-    }
-
-    /** @brief base attitude from imu.
-     * @return
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector3d> get_imu_attitude()
-    {
-        return imu_attitude_;
-    }
-
-    /** @brief base linear acceleration from imu.
-     * @return
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector3d> get_imu_linear_acceleration()
-    {
-        return imu_linear_acceleration_;
-    }
-
-    /** @brief base attitude quaternion (ordered {x, y, z, w}) from imu.
-     * @return
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector4d> get_imu_attitude_quaternion()
-    {
-        return imu_attitude_quaternion_;
+    static constexpr const char* name = "Solo12";
+    static constexpr int joint_count = 12;
+    static constexpr int motor_board_count = 6;
+
+    static constexpr std::array<int, 12> motor_numbers = {
+        {0, 3, 2, 1, 5, 4, 6, 9, 8, 7, 11, 10}};
+    static constexpr std::array<bool, 12> motor_reversed = {
+        {false, true, true, true, false, false, false, true, true, true,
+         false, false}};
+
+    /** @brief Joint limits of the HAA, HFE and KFE joints (rad). */
+    static constexpr double haa_limit = 0.9;
+    static constexpr double hfe_limit = 1.45;
+    static constexpr double kfe_limit = 2.80;
+    static constexpr std::array<double, 12> joint_lower_limits = {
+        {-haa_limit, -hfe_limit, -kfe_limit, -haa_limit, -hfe_limit,
+         -kfe_limit, -haa_limit, -hfe_limit, -kfe_limit, -haa_limit,
+         -hfe_limit, -kfe_limit}};
+    static constexpr std::array<double, 12> joint_upper_limits = {
+        {haa_limit, hfe_limit, kfe_limit, haa_limit, hfe_limit, kfe_limit,
+         haa_limit, hfe_limit, kfe_limit, haa_limit, hfe_limit, kfe_limit}};
+
+    static constexpr std::array<odri_control_interface::CalibrationMethod, 12>
+        calibration_directions = {{odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::NEGATIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::NEGATIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE}};
+
+    static constexpr double motor_torque_constant = 0.025;
+    static constexpr double joint_gear_ratio = 9.0;
+    static constexpr double motor_inertia = 0.045;
+    static constexpr double motor_max_current = 8.0;
+    static constexpr double max_joint_velocity = 80.;
+    static constexpr double safety_damping = 0.2;
+
+    static constexpr std::array<long, 3> imu_rotate_vector = {{1, 2, 3}};
+    static constexpr std::array<long, 4> imu_orientation_vector = {
+        {1, 2, 3, 4}};
+
+    static constexpr double calibration_kp = 5.;
+    static constexpr double calibration_kd = 0.05;
+    static constexpr double calibration_duration = 1.0;
+    static constexpr double calibration_dt = 0.001;
+
+    /** @brief The slider box is given explicitly to Solo12::initialize(). */
+    static const char* default_serial_port()
+    {
+        return "";
     }
+};
 
-    /*
-     * Hardware Status
-     */
-
-    /**
-     * @brief get_motor_enabled
-     * @return This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    const std::array<bool, 12>& get_motor_enabled()
-    {
-        return motor_enabled_;
-    }
-
-    /**
-     * @brief get_motor_ready
-     * @return This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    const std::array<bool, 12>& get_motor_ready()
-    {
-        return motor_ready_;
-    }
-
-    /**
-     * @brief get_motor_board_enabled
-     * @return This gives the status (enabled/disabled of the onboard control
-     * cards).
-     */
-    const std::array<bool, 6>& get_motor_board_enabled()
-    {
-        return motor_board_enabled_;
-    }
-
-    /**
-     * @brief get_motor_board_errors
-     * @return This gives the status (enabled/disabled of the onboard control
-     * cards).
-     */
-    const std::array<int, 6>& get_motor_board_errors()
-    {
-        return motor_board_errors_;
-    }
-
-    /**
-     * @brief has_error
-     * @return Returns true if the robot hardware has an error, false otherwise.
-     */
-    bool has_error() const
-    {
-        return robot_->HasError();
-    }
-
-    /**
-     * @brief is_calibrating()
-     * @return Returns true if the calibration procedure is running right now.
-     */
-    bool is_calibrating()
-    {
-        return _is_calibrating;
-    }
-
-private:
-    /**
-     * Joint properties
-     */
-
-    /** @brief Motors inertia. */
-    Vector12d motor_inertias_;
-    /** @brief DCM motor torque constants. */
-    Vector12d motor_torque_constants_;
-    /** @brief joint gear ratios (9). */
-    Vector12d joint_gear_ratios_;
-    /** @brief Max appliable current before the robot shutdown. */
-    Vector12d motor_max_current_;
-    /** @brief Offset to the theoretical "0" pose. */
-    Vector12d joint_zero_positions_;
-    /** @brief Max joint torques (Nm) */
-    Eigen::Array<double, 12, 1> max_joint_torques_;
-    /** @brief  Security margin on the saturation of the control. */
-    static const double max_joint_torque_security_margin_;
-
-    /**
-     * -------------------------------------------------------------------------
-     * Hardware status
-     */
-
-    /**
-     * @brief This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    std::array<bool, 12> motor_enabled_;
-
-    /**
-     * @brief This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    std::array<bool, 12> motor_ready_;
-
-    /**
-     * @brief This gives the status
-     * (enabled/disabled of the onboard control cards).
-     */
-    std::array<bool, 6> motor_board_enabled_;
-
-    /**
-     * @brief This gives the status
-     * (enabled/disabled of the onboard control cards).
-     */
-    std::array<int, 6> motor_board_errors_;
-
-    /**
-     * Joint data
-     */
-
-    /**
-     * @brief joint_positions_
-     */
-    Vector12d joint_positions_;
-    /**
-     * @brief joint_velocities_
-     */
-    Vector12d joint_velocities_;
-    /**
-     * @brief joint_torques_
-     */
-    Vector12d joint_torques_;
-    /**
-     * @brief joint_target_torques_
-     */
-    Vector12d joint_target_torques_;
-    /**
-     * @brief joint_encoder_index_
-     */
-    Vector12d joint_encoder_index_;
-
-    /**
-     * -------------------------------------------------------------------------
-     * Additional data
-     */
-
-    /**
-     * @brief slider_positions_ is the position of the linear potentiometer.
-     * Can be used as a joystick input.
-     */
-    Eigen::Vector4d slider_positions_;
-
-    /**
-     * @brief For reading the raw slider values from the serial port.
-     */
-    std::vector<int> slider_positions_vector_;
-
-    /**
-     * @brief contact_sensors_ is contact sensors at each feet of teh quadruped.
-     */
-    Eigen::Vector4d contact_sensors_states_;
-
-    /** @brief This is the name of the network: Left column in ifconfig output
-     */
-    std::string network_id_;
-
-    /** @brief Map the joint id to the motor board id, @see Solo12 description.
-     */
-    std::array<int, 12> map_joint_id_to_motor_board_id_;
-    /** @brief Map the joint id to the motor port id, @see Solo12 description.
-     */
-    std::array<int, 12> map_joint_id_to_motor_port_id_;
-
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_accelerometer_;
-
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_gyroscope_;
-
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_attitude_;
-
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_linear_acceleration_;
-
-    /** @brief base attitude quaternion. */
-    Eigen::Vector4d imu_attitude_quaternion_;
-
-    /** @brief State of the solo robot. */
-    Solo12State state_;
-
-    /** @brief Controller to run the calibration procedure */
-    std::shared_ptr<odri_control_interface::JointCalibrator> calib_ctrl_;
+/**
+ * @brief Definition and drivers for the Solo12 robot.
+ */
+typedef SoloRobot<Solo12Traits> Solo12;
 
-    /** @brief Indicator if calibration should start. */
-    bool calibrate_request_;
+/**
+ * @brief State of Solo12.
+ */
+typedef SoloState Solo12State;
 
-    /**
-     * Drivers communication objects
-     */
+/**
+ * @brief Phases of the control cycle whose duration is monitored by Solo12.
+ */
+typedef SoloTimingPhase Solo12TimingPhase;
 
-    /**
-     * @brief Main board drivers.
-     *
-     * PC <- Ethernet/Wifi -> main board <- SPI -> Motor Board
-     */
-    std::shared_ptr<MasterBoardInterface> main_board_ptr_;
+/**
+ * @brief Timing statistics of the Solo12 control cycle.
+ */
+typedef SoloTimingStatistics Solo12TimingStatistics;
 
-    /**
-     * @brief Reader for serial port to read arduino slider values.
-     */
-    std::shared_ptr<blmc_drivers::SerialReader> serial_reader_;
+/**
+ * @brief Sensor frame published by Solo12 at every acquire_sensors().
+ */
+typedef Solo12::Frame Solo12SensorFrame;
 
-    /**
-     * @brief The odri robot abstraction.
-     */
-    std::shared_ptr<odri_control_interface::Robot> robot_;
+/**
+ * @brief Record of one Solo12 control cycle, see set_flight_recorder().
+ */
+typedef Solo12::Record Solo12FlightRecord;
 
-    /**
-     * @brief Collection of Joints for solo12.
-     */
-    std::shared_ptr<odri_control_interface::JointModules> joints_;
+/**
+ * @brief Flight recorder fed by Solo12.
+ */
+typedef Solo12::Recorder Solo12FlightRecorder;
 
-    /**
-     * @brief Robot Imu drivers.
-     */
-    std::shared_ptr<odri_control_interface::IMU> imu_;
+/**
+ * @brief Master board backend driving Solo12, see Solo12::initialize().
+ */
+typedef Solo12::Backend Solo12Backend;
 
-    /** @brief If the physical estop is pressed or not. */
-    bool active_estop_;
+/**
+ * @brief Description of Solo12 for the master board backends.
+ */
+typedef Solo12::BackendConfig Solo12BackendConfig;
 
-    /** @brief If the joint calibration is active or not. */
-    bool _is_calibrating;
-};
+// Compiled once in the solo12 library.
+extern template class SoloRobot<Solo12Traits>;
 
 }  // namespace solo
@@ -8,389 +8,104 @@
 
 #pragma once
 
-#include <blmc_drivers/serial_reader.hpp>
-#include <solo/common_header.hpp>
-#include <solo/slider.hpp>
-#include <odri_control_interface/calibration.hpp>
-#include <odri_control_interface/robot.hpp>
+#include <solo/solo_robot.hpp>
 
 namespace solo
 {
-enum Solo8State
-{
-    initial,
-    ready,
-    calibrate
-};
-
-class Solo8
+/**
+ * @brief Definition of the Solo8 robot: the HFE and KFE joints of the four
+ * legs.
+ */
+struct Solo8Traits
 {
-public:
-    /**
-     * @brief Solo8 is the constructor of the class.
-     */
-    Solo8();
-
-    /**
-     * @brief initialize the robot by setting aligning the motors and calibrate
-     * the sensors to 0
-     */
-    void initialize(const std::string& network_id);
-
-    /**
-     * @brief send_target_torques sends the target currents to the motors
-     */
-    void send_target_joint_torque(
-        const Eigen::Ref<Vector8d> target_joint_torque);
-
-    /**
-     * @brief acquire_sensors acquire all available sensors, WARNING !!!!
-     * this method has to be called prior to any getter to have up to date data.
-     */
-    void acquire_sensors();
-
-    /**
-     * @brief Asynchrounous calibrate the joints by moving to the next joint index position.
-     *
-     * @param home_offset_rad This is the angle between the index and the zero
-     * pose.
-     * @return true
-     * @return false
-     */
-    bool request_calibration(const Vector8d& home_offset_rad);
-
-    /**
-     * Joint properties
-     */
-
-    /**
-     * @brief get_motor_inertias
-     * @return the motor inertias
-     */
-    const Eigen::Ref<Vector8d> get_motor_inertias()
-    {
-        return motor_inertias_;
-    }
-
-    /**
-     * @brief get_motor_torque_constants
-     * @return the torque constants of each motor
-     */
-    const Eigen::Ref<Vector8d> get_motor_torque_constants()
-    {
-        return motor_torque_constants_;
-    }
-
-    /**
-     * @brief get_joint_gear_ratios
-     * @return  the joint gear ratios
-     */
-    const Eigen::Ref<Vector8d> get_joint_gear_ratios()
-    {
-        return joint_gear_ratios_;
-    }
-
-    /**
-     * @brief get_max_torque
-     * @return the max torque that has been hardcoded in the constructor of this
-     * class. TODO: parametrize this via yaml or something else.
-     */
-    const Eigen::Ref<Vector8d> get_motor_max_current()
-    {
-        return motor_max_current_;
-    }
-
-    /**
-     * Sensor Data
-     */
-
-    /**
-     * @brief get_joint_positions
-     * @return  the joint angle of each module
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector8d> get_joint_positions()
-    {
-        return joint_positions_;
-    }
-
-    /**
-     * @brief get_joint_velocities
-     * @return the joint velocities
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector8d> get_joint_velocities()
-    {
-        return joint_velocities_;
-    }
-
-    /**
-     * @brief get_joint_torques
-     * @return the joint torques
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector8d> get_joint_torques()
-    {
-        return joint_torques_;
-    }
-
-    /**
-     * @brief get_joint_torques
-     * @return the target joint torques
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-
-     */
-    const Eigen::Ref<Vector8d> get_joint_target_torques()
-    {
-        return joint_target_torques_;
-    }
-
-    /**
-     * @brief get_joint_encoder_index
-     * @return the position of the index of the encoders a the motor level
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Vector8d> get_joint_encoder_index()
-    {
-        return joint_encoder_index_;
-    }
-
-    /**
-     * @brief get_contact_sensors_states
-     * @return the state of the contacts states
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector4d> get_contact_sensors_states()
-    {
-        return contact_sensors_states_;
-    }
-
-    /**
-     * @brief get_slider_positions
-     * @return the current sliders positions.
-     * WARNING !!!!
-     * The method <acquire_sensors>"()" has to be called
-     * prior to any getter to have up to date data.
-     */
-    const Eigen::Ref<Eigen::Vector4d> get_slider_positions()
-    {
-        return slider_positions_;
-    }
-
-    /**
-     * Hardware Status
-     */
-
-    /**
-     * @brief get_motor_enabled
-     * @return This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    const std::array<bool, 8>& get_motor_enabled()
+    static constexpr const char* name = "Solo8";
+    static constexpr int joint_count = 8;
+    static constexpr int motor_board_count = 4;
+
+    static constexpr std::array<int, 8> motor_numbers = {
+        {0, 1, 3, 2, 5, 4, 6, 7}};
+    static constexpr std::array<bool, 8> motor_reversed = {
+        {true, true, false, false, true, true, false, false}};
+
+    /** @brief Joint limits of the HFE and KFE joints (rad). */
+    static constexpr double hfe_limit = 1.45;
+    static constexpr double kfe_limit = 2.80;
+    static constexpr std::array<double, 8> joint_lower_limits = {
+        {-hfe_limit, -kfe_limit, -hfe_limit, -kfe_limit, -hfe_limit,
+         -kfe_limit, -hfe_limit, -kfe_limit}};
+    static constexpr std::array<double, 8> joint_upper_limits = {
+        {hfe_limit, kfe_limit, hfe_limit, kfe_limit, hfe_limit, kfe_limit,
+         hfe_limit, kfe_limit}};
+
+    static constexpr std::array<odri_control_interface::CalibrationMethod, 8>
+        calibration_directions = {{odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE,
+                                   odri_control_interface::POSITIVE}};
+
+    static constexpr double motor_torque_constant = 0.025;
+    static constexpr double joint_gear_ratio = 9.0;
+    static constexpr double motor_inertia = 0.045;
+    static constexpr double motor_max_current = 4.0;
+    static constexpr double max_joint_velocity = 80.;
+    static constexpr double safety_damping = 0.2;
+
+    static constexpr std::array<long, 3> imu_rotate_vector = {{1, 2, 3}};
+    static constexpr std::array<long, 4> imu_orientation_vector = {
+        {1, 2, 3, 4}};
+
+    static constexpr double calibration_kp = 5.;
+    static constexpr double calibration_kd = 0.05;
+    static constexpr double calibration_duration = 1.0;
+    static constexpr double calibration_dt = 0.001;
+
+    /** @brief Solo8 always looks for the slider box on the arduino ports. */
+    static const char* default_serial_port()
     {
-        return motor_enabled_;
+        return "/dev/ttyACM0";
     }
+};
 
-    /**
-     * @brief get_motor_ready
-     * @return This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    const std::array<bool, 8>& get_motor_ready()
-    {
-        return motor_ready_;
-    }
-
-    /**
-     * @brief get_motor_board_enabled
-     * @return This gives the status (enabled/disabled of the onboard control
-     * cards).
-     */
-    const std::array<bool, 4>& get_motor_board_enabled()
-    {
-        return motor_board_enabled_;
-    }
-
-    /**
-     * @brief get_motor_board_errors
-     * @return This gives the status (enabled/disabled of the onboard control
-     * cards).
-     */
-    const std::array<int, 4>& get_motor_board_errors()
-    {
-        return motor_board_errors_;
-    }
-
-private:
-    /**
-     * Motor data
-     */
-
-    /**
-     * Joint properties
-     */
-    Vector8d motor_inertias_;         /**< motors inertia. */
-    Vector8d motor_torque_constants_; /**< DCM motor torque constants. */
-    Vector8d joint_gear_ratios_;      /**< joint gear ratios (9). */
-    Vector8d motor_max_current_;    /**< Max appliable current before the robot
-                                       shutdown. */
-    Vector8d joint_zero_positions_; /**< Offset to the theoretical "0" pose. */
-    Eigen::Array<double, 8, 1>
-        max_joint_torques_; /**< Max joint torques (Nm) */
-    static const double
-        max_joint_torque_security_margin_; /**<  Security margin on the
-                                              saturation of the control. */
-
-    /**
-     * Hardware status
-     */
-    /**
-     * @brief This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    std::array<bool, 8> motor_enabled_;
-
-    /**
-     * @brief This gives the status (enabled/disabled) of each motors using the
-     * joint ordering convention.
-     */
-    std::array<bool, 8> motor_ready_;
-
-    /**
-     * @brief This gives the status (enabled/disabled of the onboard control
-     * cards).
-     */
-    std::array<bool, 4> motor_board_enabled_;
-
-    /**
-     * @brief This gives the status (enabled/disabled of the onboard control
-     * cards).
-     */
-    std::array<int, 4> motor_board_errors_;
-
-    /**
-     * Joint data
-     */
-
-    /**
-     * @brief joint_positions_
-     */
-    Vector8d joint_positions_;
-    /**
-     * @brief joint_velocities_
-     */
-    Vector8d joint_velocities_;
-    /**
-     * @brief joint_torques_
-     */
-    Vector8d joint_torques_;
-    /**
-     * @brief joint_target_torques_
-     */
-    Vector8d joint_target_torques_;
-    /**
-     * @brief joint_encoder_index_
-     */
-    Vector8d joint_encoder_index_;
-
-    /**
-     * Additional data
-     */
-
-    /**
-     * @brief slider_positions_ is the position of the linear potentiometer.
-     * Can be used as a joystick input.
-     */
-    Eigen::Vector4d slider_positions_;
-
-    /**
-     * @brief contact_sensors_ is contact sensors at each feet of teh quadruped.
-     */
-    Eigen::Vector4d contact_sensors_states_;
-
-    /**
-     * Drivers communication objects
-     */
-
-    /**
-     * @brief Reader for serial port to read arduino slider values.
-     */
-    std::shared_ptr<blmc_drivers::SerialReader> serial_reader_;
-
-    /**
-     * @brief Main board drivers.
-     *
-     * PC <- Ethernet/Wifi -> main board <- SPI -> Motor Board
-     */
-    std::shared_ptr<MasterBoardInterface> main_board_ptr_;
-
-    /**
-     * @brief The odri robot abstraction.
-     */
-    std::shared_ptr<odri_control_interface::Robot> robot_;
-
-    /**
-     * @brief Collection of Joints for solo12.
-     */
-    std::shared_ptr<odri_control_interface::JointModules> joints_;
-
-    /** @brief Controller to run the calibration procedure */
-    std::shared_ptr<odri_control_interface::JointCalibrator> calib_ctrl_;
-
-    /** @brief Indicator if calibration should start. */
-    bool calibrate_request_;
-
-    /**
-     * @brief For reading the raw slider values from the serial port.
-     */
-    std::vector<int> slider_positions_vector_;
-
-    /**
-     * @brief contact_sensors_ is the contact sensors at each foot tips. They
-     * also are analogue inputs.
-     */
-    std::array<ContactSensor_ptr, 4> contact_sensors_;
-
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_accelerometer_;
-
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_gyroscope_;
+/**
+ * @brief Definition and drivers for the Solo8 robot.
+ */
+typedef SoloRobot<Solo8Traits> Solo8;
 
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_attitude_;
+/**
+ * @brief State of Solo8.
+ */
+typedef SoloState Solo8State;
 
-    /** @brief base accelerometer. */
-    Eigen::Vector3d imu_linear_acceleration_;
+/**
+ * @brief Sensor frame published by Solo8 at every acquire_sensors().
+ */
+typedef Solo8::Frame Solo8SensorFrame;
 
-    /** @brief base attitude quaternion. */
-    Eigen::Vector4d imu_attitude_quaternion_;
+/**
+ * @brief Record of one Solo8 control cycle, see set_flight_recorder().
+ */
+typedef Solo8::Record Solo8FlightRecord;
 
-    /**
-     * @brief Robot Imu drivers.
-     */
-    std::shared_ptr<odri_control_interface::IMU> imu_;
+/**
+ * @brief Flight recorder fed by Solo8.
+ */
+typedef Solo8::Recorder Solo8FlightRecorder;
 
-    /** @brief If the physical estop is pressed or not. */
-    bool active_estop_;
+/**
+ * @brief Master board backend driving Solo8, see Solo8::initialize().
+ */
+typedef Solo8::Backend Solo8Backend;
 
-    /** @brief If the joint calibration is active or not. */
-    bool _is_calibrating;
+/**
+ * @brief Description of Solo8 for the master board backends.
+ */
+typedef Solo8::BackendConfig Solo8BackendConfig;
 
-    /** @brief State of the solo robot. */
-    Solo8State state_;
-};
+// Compiled once in the solo8 library.
+extern template class SoloRobot<Solo8Traits>;
 
 }  // namespace solo
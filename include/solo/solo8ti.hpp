@@ -8,11 +8,46 @@
 #pragma once
 
 #include <blmc_drivers/blmc_joint_module.hpp>
+#include <solo/can_bus_telemetry.hpp>
 #include <solo/common_header.hpp>
+#include <solo/flight_recorder.hpp>
+#include <solo/sensor_frame.hpp>
+#include <solo/seqlock.hpp>
 #include <solo/slider.hpp>
 
 namespace solo
 {
+/**
+ * @brief Sensor frame published by Solo8TI at every acquire_sensors().
+ */
+typedef SensorFrame<8, 4> Solo8TISensorFrame;
+
+/**
+ * @brief Record of one Solo8TI control cycle, see set_flight_recorder().
+ */
+typedef FlightRecord<8, 4> Solo8TIFlightRecord;
+
+/**
+ * @brief Flight recorder fed by Solo8TI.
+ */
+typedef FlightRecorder<Solo8TIFlightRecord> Solo8TIFlightRecorder;
+
+/**
+ * @brief Step of the Solo8TI homing, advanced at every
+ * send_target_joint_torque().
+ */
+enum Solo8TIHomingState
+{
+    /** @brief No homing running. */
+    homing_idle,
+    /** @brief Requested, starts at the next command. */
+    homing_start,
+    /** @brief Moving the joints until their encoder index is detected. */
+    homing_search,
+    /** @brief Moving the calibrated joints to the zero pose. */
+    homing_go_to_zero
+};
+
 class Solo8TI
 {
 public:
@@ -24,14 +59,45 @@ public:
     /**
      * @brief initialize the robot by setting aligning the motors and calibrate
      * the sensors to 0
+     *
+     * The four CAN buses and motor boards are brought up concurrently, then
+     * a single barrier waits for all of them. The time each board took is
+     * logged.
+     *
+     * @param ready_timeout Maximum time to wait for the boards to be ready
+     * (s).
+     * @throw std::runtime_error naming the boards not ready in time.
      */
-    void initialize();
+    void initialize(double ready_timeout = 10.0);
 
     /**
      * @brief send_target_torques sends the target currents to the motors
+     *
+     * All the currents are set before any board sends, so each motor board
+     * sends the currents of both its ports in a single frame per call: the
+     * second send request of a board finds nothing new and is skipped.
      */
     void send_target_joint_torque(
-        const Eigen::Ref<Vector8d> target_joint_torque);
+        const Eigen::Ref<const Vector8d> target_joint_torque);
+
+    /**
+     * @brief Count the frames of the four CAN buses at every
+     * send_target_joint_torque(), see get_can_bus_statistics(). Must be
+     * called after initialize(), while the control loop is stopped.
+     *
+     * @param bitrate Bit rate of the buses (bit/s).
+     */
+    void enable_can_telemetry(double bitrate = 1e6);
+
+    /**
+     * @brief get_can_bus_statistics
+     * @param bus Index of the bus, can0 to can3.
+     * @return The traffic of the bus, see enable_can_telemetry().
+     */
+    const CanBusStatistics& get_can_bus_statistics(int bus) const
+    {
+        return can_bus_telemetry_[bus].get_statistics();
+    }
 
     /**
      * @brief acquire_sensors acquire all available sensors, WARNING !!!!
@@ -40,15 +106,66 @@ public:
     void acquire_sensors();
 
     /**
-     * @brief Calibrate the joints by moving to the next joint index position.
+     * @brief Acquire all the sensors like acquire_sensors(), and record when
+     * each CAN bus sampled its joints.
+     *
+     * The four buses stream their measurements independently, so the joints
+     * of one frame can come from instants up to a bus period apart. The joint
+     * positions of each bus are read at the time index of its newest position
+     * sample, together with the time of that sample, see get_bus_timestamps()
+     * and get_bus_skew().
+     *
+     * @param align_to_newest_bus If true, the joint positions of the older
+     * buses are moved to the newest bus timestamp with their measured
+     * velocities (linear interpolation), so the frame describes a single
+     * instant.
+     */
+    void acquire_sensors_snapshot(bool align_to_newest_bus = false);
+
+    /**
+     * @brief Asynchronously request for the calibration.
+     *
+     * The homing then runs one step per send_target_joint_torque(), which
+     * ignores the given torques until is_calibrating() is false: each joint
+     * moves until its encoder index is detected, then all of them go to the
+     * zero pose. The sensors keep streaming and the control loop keeps its
+     * period.
      *
      * @param home_offset_rad This is the angle between the index and the zero
      * pose.
      * @return true
-     * @return false
+     */
+    bool request_calibration(const Vector8d& home_offset_rad);
+
+    /**
+     * @brief Calibrate the joints by moving to the next joint index position.
+     * Blocking: runs request_calibration() with its own 1 kHz loop, so it
+     * must not be called while a control loop is running.
+     *
+     * @param home_offset_rad This is the angle between the index and the zero
+     * pose.
+     * @return true if all the indexes were found.
      */
     bool calibrate(const Vector8d& home_offset_rad);
 
+    /**
+     * @brief is_calibrating()
+     * @return Returns true if the calibration procedure is running right now.
+     */
+    bool is_calibrating() const
+    {
+        return homing_state_ != homing_idle;
+    }
+
+    /**
+     * @brief is_calibrated()
+     * @return Returns true if the last calibration found all the indexes.
+     */
+    bool is_calibrated() const
+    {
+        return is_calibrated_;
+    }
+
     /**
      * Joint properties
      */
@@ -179,6 +296,38 @@ public:
         return slider_positions_;
     }
 
+    /**
+     * @brief get_bus_timestamps
+     * @return Time of the newest position sample of each CAN bus (s), in the
+     * clock of the blmc_drivers time series, NaN before the first sample.
+     * WARNING !!!!
+     * The method <acquire_sensors_snapshot>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const std::array<double, 4>& get_bus_timestamps()
+    {
+        return bus_timestamps_;
+    }
+
+    /**
+     * @brief get_bus_skew
+     * @return Time between the oldest and the newest bus samples of the last
+     * snapshot (s).
+     */
+    double get_bus_skew()
+    {
+        return bus_skew_;
+    }
+
+    /**
+     * @brief get_max_bus_skew
+     * @return Largest skew seen since the construction (s).
+     */
+    double get_max_bus_skew()
+    {
+        return max_bus_skew_;
+    }
+
     /**
      * Hardware Status
      */
@@ -223,6 +372,47 @@ public:
         return motor_board_errors_;
     }
 
+    /*
+     * Thread safe access to the sensor data
+     */
+
+    /**
+     * @brief Copy the latest sensor frame published by acquire_sensors().
+     *
+     * This can be called from any thread while the control loop is running.
+     * It never blocks the control loop, see SeqLock.
+     *
+     * @param[out] frame The latest complete sensor frame.
+     * @return uint64_t The number of frames published so far.
+     */
+    uint64_t read_sensor_frame(Solo8TISensorFrame& frame) const
+    {
+        return sensor_frame_publisher_.read(frame);
+    }
+
+    /**
+     * @brief get_sensor_frame_version
+     * @return The number of frames published so far. Thread safe.
+     */
+    uint64_t get_sensor_frame_version() const
+    {
+        return sensor_frame_publisher_.get_version();
+    }
+
+    /**
+     * @brief Record every control cycle into the given flight recorder.
+     *
+     * At each send_target_joint_torque() the latest sensor frame and the
+     * commanded torques are queued to the recorder. Set nullptr to stop
+     * recording. Must not be called while the control loop is running.
+     *
+     * @param flight_recorder
+     */
+    void set_flight_recorder(std::shared_ptr<Solo8TIFlightRecorder> flight_recorder)
+    {
+        flight_recorder_ = flight_recorder;
+    }
+
 private:
     /**
      * Motor data
@@ -359,6 +549,136 @@ private:
      * also are analogue inputs.
      */
     std::array<ContactSensor_ptr, 4> contact_sensors_;
+
+    /**
+     * @brief Time of the newest position sample of each CAN bus (s).
+     */
+    std::array<double, 4> bus_timestamps_;
+
+    /**
+     * @brief Newest of the bus_timestamps_ with a sample, NaN if none (s).
+     */
+    double newest_bus_timestamp_;
+
+    /**
+     * @brief Spread of bus_timestamps_ (s).
+     */
+    double bus_skew_;
+
+    /**
+     * @brief Largest bus_skew_ seen (s).
+     */
+    double max_bus_skew_;
+
+    /*
+     * Homing, see request_calibration().
+     */
+
+    /** @brief Current step of the homing. */
+    Solo8TIHomingState homing_state_;
+    /** @brief If the last homing found all the indexes. */
+    bool is_calibrated_;
+    /** @brief Angles between the indexes and the zero pose (rad). */
+    Vector8d homing_offsets_;
+    /** @brief Zero angles before the homing, restored if it fails (rad). */
+    Vector8d homing_previous_zero_angles_;
+    /** @brief Zero angles found by the homing (rad). */
+    Vector8d homing_zero_angles_;
+    /** @brief Position tracked by each joint (rad). */
+    Vector8d homing_targets_;
+    /** @brief Positions when going to the zero pose starts (rad). */
+    Vector8d homing_start_positions_;
+    /** @brief If the index of each joint was detected. */
+    std::array<bool, 8> homing_index_found_;
+    /** @brief Newest encoder index sample of each motor before the search. */
+    std::array<long, 8> homing_index_time_indexes_;
+    /** @brief Steps done by the index search. */
+    int homing_step_count_;
+    /** @brief Start of the motion to the zero pose (s). */
+    double homing_go_to_zero_start_;
+    /** @brief Duration of the motion to the zero pose (s). */
+    double homing_go_to_zero_duration_;
+
+    /** @brief Distance searched for an index before failing (rad). */
+    static const double homing_search_distance_limit_;
+    /** @brief Displacement of the search targets per cycle (rad). */
+    static const double homing_step_size_;
+    /** @brief Position gain of the homing (Nm/rad). */
+    static const double homing_kp_;
+    /** @brief Velocity gain of the homing (Nm s/rad). */
+    static const double homing_kd_;
+    /** @brief Mean velocity of the motion to the zero pose (rad/s). */
+    static const double homing_go_to_zero_velocity_;
+
+    /**
+     * @brief Advance the homing by one cycle.
+     *
+     * @param[out] torques The homing torques (Nm).
+     */
+    void update_homing(Vector8d& torques);
+
+    /**
+     * @brief Newest time index of the encoder index samples of a motor, -1
+     * if there is none.
+     */
+    long get_newest_index_time_index(int motor) const;
+
+    /** @brief If the CAN traffic is counted. */
+    bool is_can_telemetry_enabled_;
+
+    /** @brief Traffic of each CAN bus. */
+    std::array<CanBusTelemetry, 4> can_bus_telemetry_;
+
+    /**
+     * @brief Read the joint data but the positions, and the slider, contact
+     * and status data.
+     */
+    void read_sensors();
+
+    /**
+     * @brief Read the joint positions and bus_timestamps_ at the newest time
+     * index of each bus, and update the skew.
+     */
+    void read_bus_snapshot();
+
+    /**
+     * @brief Publish the current sensor data to the other threads.
+     */
+    void publish_sensor_frame();
+
+    /**
+     * @brief Open the CAN buses and start the motor boards, one thread per
+     * bus.
+     *
+     * @param[out] bring_up_durations Time to construct each bus and board
+     * (s).
+     */
+    void bring_up_can_buses(std::array<double, 4>& bring_up_durations);
+
+    /**
+     * @brief Wait until all the motor boards are ready.
+     *
+     * @param ready_timeout (s)
+     * @param bring_up_durations Logged next to the readiness times (s).
+     * @throw std::runtime_error naming the boards not ready in time.
+     */
+    void wait_until_boards_ready(
+        double ready_timeout, const std::array<double, 4>& bring_up_durations);
+
+    /** @brief Legs driven by each CAN bus, for the messages. */
+    static const std::array<const char*, 4> can_bus_legs_;
+
+    /** @brief Staging frame filled at every acquire_sensors(). */
+    Solo8TISensorFrame sensor_frame_;
+
+    /** @brief Lock free publisher of the latest sensor frame. */
+    SeqLock<Solo8TISensorFrame> sensor_frame_publisher_;
+
+    /** @brief Optional recorder of every control cycle. */
+    std::shared_ptr<Solo8TIFlightRecorder> flight_recorder_;
+
+    /** @brief Record filled at every send_target_joint_torque(). */
+    Solo8TIFlightRecord flight_record_;
 };
 
 }  // namespace solo
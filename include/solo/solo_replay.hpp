@@ -0,0 +1,513 @@
+/**
+ * @file solo_replay.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Drive a controller written for the robot classes from a flight
+ * record instead of the hardware.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/Eigen>
+
+#include "solo/flight_record_reader.hpp"
+#include "solo/sensor_frame.hpp"
+
+namespace solo
+{
+/**
+ * @brief Stand-in for a robot class (e.g. Solo12) that serves the sensor data
+ * of a flight record.
+ *
+ * The getters have the same signatures as the ones of the robot class so a
+ * controller templated on the robot type runs unchanged. Each
+ * acquire_sensors() loads the next recorded cycle, and
+ * send_target_joint_torque() stores the torques of the controller next to
+ * the ones commanded during the recording. Nothing waits on a clock, so a
+ * session replays as fast as the controller computes.
+ *
+ * @tparam JOINT_COUNT Number of joints.
+ * @tparam MOTOR_BOARD_COUNT Number of motor driver boards.
+ */
+template <int JOINT_COUNT, int MOTOR_BOARD_COUNT>
+class SoloReplay
+{
+public:
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, JOINT_COUNT, 1> JointVector;
+    /** @brief Record type read from the file. */
+    typedef FlightRecord<JOINT_COUNT, MOTOR_BOARD_COUNT> Record;
+    /** @brief Sensor frame type of the replayed robot. */
+    typedef SensorFrame<JOINT_COUNT, MOTOR_BOARD_COUNT> Frame;
+
+    /**
+     * @brief Construct a new SoloReplay object.
+     */
+    SoloReplay()
+    {
+        position_ = 0;
+        record_ = nullptr;
+        joint_positions_.setZero();
+        joint_velocities_.setZero();
+        joint_torques_.setZero();
+        joint_target_torques_.setZero();
+        joint_encoder_index_.setZero();
+        slider_positions_.setZero();
+        contact_sensors_states_.setZero();
+        imu_accelerometer_.setZero();
+        imu_gyroscope_.setZero();
+        imu_attitude_.setZero();
+        imu_linear_acceleration_.setZero();
+        imu_attitude_quaternion_ << 0.0, 0.0, 0.0, 1.0;
+        motor_enabled_.fill(false);
+        motor_ready_.fill(false);
+        motor_board_enabled_.fill(false);
+        motor_board_errors_.fill(0);
+        replayed_torques_.setZero();
+        recorded_torques_.setZero();
+        max_torque_difference_ = 0.0;
+    }
+
+    /**
+     * @brief Open a flight record and rewind to its oldest cycle.
+     *
+     * @param flight_record_file File written by a FlightRecorder of the same
+     * robot. Throws std::runtime_error if it cannot be read.
+     */
+    void initialize(const std::string& flight_record_file)
+    {
+        reader_ =
+            std::make_shared<FlightRecordReader<Record> >(flight_record_file);
+        rewind();
+    }
+
+    /**
+     * @brief Restart the replay from the oldest recorded cycle.
+     */
+    void rewind()
+    {
+        position_ = 0;
+        record_ = nullptr;
+        max_torque_difference_ = 0.0;
+    }
+
+    /**
+     * @brief Load the sensor data of the next recorded cycle.
+     *
+     * Throws std::runtime_error when called after the last cycle, see
+     * is_finished().
+     */
+    void acquire_sensors()
+    {
+        if (is_finished())
+        {
+            throw std::runtime_error(
+                "SoloReplay: no more recorded cycles to replay.");
+        }
+        record_ = &(*reader_)[position_];
+        ++position_;
+
+        for (int i = 0; i < JOINT_COUNT; ++i)
+        {
+            joint_positions_(i) = record_->joint_positions[i];
+            joint_velocities_(i) = record_->joint_velocities[i];
+            joint_torques_(i) = record_->joint_torques[i];
+            joint_target_torques_(i) = record_->joint_target_torques[i];
+            joint_encoder_index_(i) = record_->joint_encoder_index[i];
+            recorded_torques_(i) = record_->joint_commanded_torques[i];
+            motor_enabled_[i] = record_->motor_enabled[i] != 0;
+            motor_ready_[i] = record_->motor_ready[i] != 0;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            slider_positions_(i) = record_->slider_positions[i];
+            contact_sensors_states_(i) = record_->contact_sensors_states[i];
+            imu_attitude_quaternion_(i) = record_->imu_attitude_quaternion[i];
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            imu_accelerometer_(i) = record_->imu_accelerometer[i];
+            imu_gyroscope_(i) = record_->imu_gyroscope[i];
+            imu_attitude_(i) = record_->imu_attitude[i];
+            imu_linear_acceleration_(i) = record_->imu_linear_acceleration[i];
+        }
+        for (int i = 0; i < MOTOR_BOARD_COUNT; ++i)
+        {
+            motor_board_enabled_[i] = record_->motor_board_enabled[i] != 0;
+            motor_board_errors_[i] = record_->motor_board_errors[i];
+        }
+    }
+
+    /**
+     * @brief Capture the torques the controller computed for the current
+     * cycle instead of sending them.
+     *
+     * @param target_joint_torque (Nm)
+     */
+    void send_target_joint_torque(
+        const Eigen::Ref<const JointVector> target_joint_torque)
+    {
+        replayed_torques_ = target_joint_torque;
+        max_torque_difference_ =
+            std::max(max_torque_difference_,
+                     (replayed_torques_ - recorded_torques_).cwiseAbs().maxCoeff());
+    }
+
+    /**
+     * @brief Calibration cannot be replayed, its outcome is already part of
+     * the recorded joint positions. Accepted and ignored.
+     *
+     * @return true
+     */
+    bool request_calibration(const JointVector& /*home_offset_rad*/)
+    {
+        return true;
+    }
+
+    /**
+     * @brief is_finished
+     * @return true once every recorded cycle has been acquired.
+     */
+    bool is_finished() const
+    {
+        return position_ >= size();
+    }
+
+    /**
+     * @brief Number of recorded cycles available.
+     */
+    std::size_t size() const
+    {
+        return reader_ ? reader_->size() : 0;
+    }
+
+    /**
+     * @brief Number of cycles acquired since the last rewind().
+     */
+    std::size_t get_position() const
+    {
+        return position_;
+    }
+
+    /**
+     * @brief Get the flight record reader, e.g. to check whether the
+     * recording ended with a clean shutdown.
+     */
+    const FlightRecordReader<Record>& get_reader() const
+    {
+        return *reader_;
+    }
+
+    /*
+     * Replay results
+     */
+
+    /**
+     * @brief get_replayed_torques
+     * @return The torques given to the last send_target_joint_torque() (Nm).
+     */
+    const Eigen::Ref<JointVector> get_replayed_torques()
+    {
+        return replayed_torques_;
+    }
+
+    /**
+     * @brief get_recorded_torques
+     * @return The torques commanded in the recording for the current cycle
+     * (Nm).
+     */
+    const Eigen::Ref<JointVector> get_recorded_torques()
+    {
+        return recorded_torques_;
+    }
+
+    /**
+     * @brief get_max_torque_difference
+     * @return The largest absolute difference between a replayed and a
+     * recorded torque since the last rewind() (Nm).
+     */
+    double get_max_torque_difference() const
+    {
+        return max_torque_difference_;
+    }
+
+    /*
+     * Sensor data, same interface as the robot classes
+     */
+
+    /**
+     * @brief get_joint_positions
+     * @return the joint angle of each module (rad)
+     */
+    const Eigen::Ref<JointVector> get_joint_positions()
+    {
+        return joint_positions_;
+    }
+
+    /**
+     * @brief get_joint_velocities
+     * @return the joint velocities (rad/s)
+     */
+    const Eigen::Ref<JointVector> get_joint_velocities()
+    {
+        return joint_velocities_;
+    }
+
+    /**
+     * @brief get_joint_torques
+     * @return the joint torques (Nm)
+     */
+    const Eigen::Ref<JointVector> get_joint_torques()
+    {
+        return joint_torques_;
+    }
+
+    /**
+     * @brief get_joint_target_torques
+     * @return the target joint torques reported by the hardware (Nm)
+     */
+    const Eigen::Ref<JointVector> get_joint_target_torques()
+    {
+        return joint_target_torques_;
+    }
+
+    /**
+     * @brief get_joint_encoder_index
+     * @return the position of the index of the encoders (rad)
+     */
+    const Eigen::Ref<JointVector> get_joint_encoder_index()
+    {
+        return joint_encoder_index_;
+    }
+
+    /**
+     * @brief get_contact_sensors_states
+     * @return the state of the contacts
+     */
+    const Eigen::Ref<Eigen::Vector4d> get_contact_sensors_states()
+    {
+        return contact_sensors_states_;
+    }
+
+    /**
+     * @brief get_slider_positions
+     * @return the current sliders positions in [0, 1]
+     */
+    const Eigen::Ref<Eigen::Vector4d> get_slider_positions()
+    {
+        return slider_positions_;
+    }
+
+    /**
+     * @brief get_imu_accelerometer
+     * @return the base accelerometer
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_accelerometer()
+    {
+        return imu_accelerometer_;
+    }
+
+    /**
+     * @brief get_imu_gyroscope
+     * @return the base gyroscope
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_gyroscope()
+    {
+        return imu_gyroscope_;
+    }
+
+    /**
+     * @brief get_imu_attitude
+     * @return the base attitude (euler angles)
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_attitude()
+    {
+        return imu_attitude_;
+    }
+
+    /**
+     * @brief get_imu_linear_acceleration
+     * @return the base linear acceleration
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_linear_acceleration()
+    {
+        return imu_linear_acceleration_;
+    }
+
+    /**
+     * @brief get_imu_attitude_quaternion
+     * @return the base attitude quaternion ordered {x, y, z, w}
+     */
+    const Eigen::Ref<Eigen::Vector4d> get_imu_attitude_quaternion()
+    {
+        return imu_attitude_quaternion_;
+    }
+
+    /**
+     * @brief get_motor_enabled
+     * @return the enabled status of each motor
+     */
+    const std::array<bool, JOINT_COUNT>& get_motor_enabled()
+    {
+        return motor_enabled_;
+    }
+
+    /**
+     * @brief get_motor_ready
+     * @return the ready status of each motor
+     */
+    const std::array<bool, JOINT_COUNT>& get_motor_ready()
+    {
+        return motor_ready_;
+    }
+
+    /**
+     * @brief get_motor_board_enabled
+     * @return the enabled status of each motor board
+     */
+    const std::array<bool, MOTOR_BOARD_COUNT>& get_motor_board_enabled()
+    {
+        return motor_board_enabled_;
+    }
+
+    /**
+     * @brief get_motor_board_errors
+     * @return the error code of each motor board
+     */
+    const std::array<int, MOTOR_BOARD_COUNT>& get_motor_board_errors()
+    {
+        return motor_board_errors_;
+    }
+
+    /**
+     * @brief is_ready
+     * @return the recorded ready state of the current cycle
+     */
+    bool is_ready()
+    {
+        return record_ != nullptr && record_->is_ready != 0;
+    }
+
+    /**
+     * @brief is_calibrating
+     * @return the recorded calibration state of the current cycle
+     */
+    bool is_calibrating()
+    {
+        return record_ != nullptr && record_->is_calibrating != 0;
+    }
+
+    /**
+     * @brief has_error
+     * @return the recorded error state of the current cycle
+     */
+    bool has_error() const
+    {
+        return record_ != nullptr && record_->has_error != 0;
+    }
+
+    /**
+     * @brief Copy the current cycle into a sensor frame, like
+     * read_sensor_frame() of the robot classes.
+     *
+     * @param[out] frame
+     * @return uint64_t The number of cycles acquired since the last rewind().
+     */
+    uint64_t read_sensor_frame(Frame& frame) const
+    {
+        frame = Frame();
+        if (record_ == nullptr)
+        {
+            return 0;
+        }
+        frame.cycle = record_->cycle;
+        frame.timestamp = record_->timestamp;
+        frame.joint_positions = joint_positions_;
+        frame.joint_velocities = joint_velocities_;
+        frame.joint_torques = joint_torques_;
+        frame.joint_target_torques = joint_target_torques_;
+        frame.joint_encoder_index = joint_encoder_index_;
+        frame.slider_positions = slider_positions_;
+        frame.contact_sensors_states = contact_sensors_states_;
+        frame.imu_accelerometer = imu_accelerometer_;
+        frame.imu_gyroscope = imu_gyroscope_;
+        frame.imu_attitude = imu_attitude_;
+        frame.imu_linear_acceleration = imu_linear_acceleration_;
+        frame.imu_attitude_quaternion = imu_attitude_quaternion_;
+        frame.motor_enabled = motor_enabled_;
+        frame.motor_ready = motor_ready_;
+        frame.motor_board_enabled = motor_board_enabled_;
+        frame.motor_board_errors = motor_board_errors_;
+        frame.active_estop = record_->active_estop != 0;
+        frame.is_ready = record_->is_ready != 0;
+        frame.is_calibrating = record_->is_calibrating != 0;
+        frame.has_error = record_->has_error != 0;
+        return position_;
+    }
+
+private:
+    /** @brief Reader of the flight record file. */
+    std::shared_ptr<FlightRecordReader<Record> > reader_;
+    /** @brief Chronological position of the next record to replay. */
+    std::size_t position_;
+    /** @brief Record of the current cycle, inside the mapped file. */
+    const Record* record_;
+
+    /** @brief Joint positions (rad). */
+    JointVector joint_positions_;
+    /** @brief Joint velocities (rad/s). */
+    JointVector joint_velocities_;
+    /** @brief Joint torques (Nm). */
+    JointVector joint_torques_;
+    /** @brief Target joint torques reported by the hardware (Nm). */
+    JointVector joint_target_torques_;
+    /** @brief Position of the encoder indexes (rad). */
+    JointVector joint_encoder_index_;
+    /** @brief Slider positions in [0, 1]. */
+    Eigen::Vector4d slider_positions_;
+    /** @brief Contact sensor states. */
+    Eigen::Vector4d contact_sensors_states_;
+    /** @brief Base accelerometer. */
+    Eigen::Vector3d imu_accelerometer_;
+    /** @brief Base gyroscope. */
+    Eigen::Vector3d imu_gyroscope_;
+    /** @brief Base attitude (euler angles). */
+    Eigen::Vector3d imu_attitude_;
+    /** @brief Base linear acceleration. */
+    Eigen::Vector3d imu_linear_acceleration_;
+    /** @brief Base attitude quaternion ordered {x, y, z, w}. */
+    Eigen::Vector4d imu_attitude_quaternion_;
+    /** @brief Enabled status of each motor. */
+    std::array<bool, JOINT_COUNT> motor_enabled_;
+    /** @brief Ready status of each motor. */
+    std::array<bool, JOINT_COUNT> motor_ready_;
+    /** @brief Enabled status of each motor board. */
+    std::array<bool, MOTOR_BOARD_COUNT> motor_board_enabled_;
+    /** @brief Error code of each motor board. */
+    std::array<int, MOTOR_BOARD_COUNT> motor_board_errors_;
+
+    /** @brief Torques computed by the controller for the current cycle. */
+    JointVector replayed_torques_;
+    /** @brief Torques commanded in the recording for the current cycle. */
+    JointVector recorded_torques_;
+    /** @brief Largest replayed versus recorded torque difference (Nm). */
+    double max_torque_difference_;
+};
+
+/** @brief Replay of Solo12 flight records. */
+typedef SoloReplay<12, 6> Solo12Replay;
+
+/** @brief Replay of Solo8 flight records. */
+typedef SoloReplay<8, 4> Solo8Replay;
+
+}  // namespace solo
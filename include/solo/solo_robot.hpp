@@ -0,0 +1,1374 @@
+/**
+ * @file solo_robot.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Master board robots of the Solo family, parametrized by their
+ * compile time description.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "solo/allocation_guard.hpp"
+#include "solo/calibration_cache.hpp"
+#include "solo/common_header.hpp"
+#include "solo/cycle_timing.hpp"
+#include "solo/fake_master_board_backend.hpp"
+#include "solo/flight_recorder.hpp"
+#include "solo/master_board_backend.hpp"
+#include "solo/motion_sequence.hpp"
+#include "solo/periodic_executor.hpp"
+#include "solo/pipelined_master_board_backend.hpp"
+#include "solo/sensor_frame.hpp"
+#include "solo/seqlock.hpp"
+#include "solo/serial_slider_reader.hpp"
+
+namespace solo
+{
+/**
+ * @brief State of the robots driven by SoloRobot.
+ */
+enum SoloState
+{
+    initial,
+    ready,
+    calibrate,
+    /** @brief Checking a calibration restored from the CalibrationCache. */
+    calibration_check
+};
+
+/**
+ * @brief Phases of the control cycle whose duration is monitored by
+ * SoloRobot.
+ */
+enum SoloTimingPhase
+{
+    /** @brief Parsing of the master board packet. */
+    timing_parse_sensor_data = 0,
+    /** @brief Copy of the joint data. */
+    timing_joint_data,
+    /** @brief Read of the serial port sliders and estop. */
+    timing_slider_data,
+    /** @brief Copy of the imu data. */
+    timing_imu_data,
+    /** @brief Copy of the motor and motor board status. */
+    timing_status_data,
+    /** @brief The complete acquire_sensors() call. */
+    timing_acquire_sensors,
+    /** @brief The complete send_target_joint_torque() call. */
+    timing_send_target_joint_torque,
+    /** @brief Number of monitored phases. */
+    timing_phase_count
+};
+
+/**
+ * @brief Timing statistics of the SoloRobot control cycle.
+ */
+typedef CycleTimingStatistics<timing_phase_count> SoloTimingStatistics;
+
+/**
+ * @brief Robot driven through a master board: the joints, the imu and the
+ * optional slider box.
+ *
+ * Everything that differs between the robot variants is read from the
+ * Traits at compile time, so each variant works on fixed size Eigen types
+ * end to end. The Traits must define:
+ *
+ * - `static constexpr const char* name`, used in the messages.
+ * - `static constexpr int joint_count` and `motor_board_count`.
+ * - `static constexpr std::array<int, joint_count> motor_numbers`, the motor
+ *   index of each joint, and `std::array<bool, joint_count> motor_reversed`.
+ * - `static constexpr std::array<double, joint_count> joint_lower_limits`
+ *   and `joint_upper_limits` (rad).
+ * - `static constexpr std::array<odri_control_interface::CalibrationMethod,
+ *   joint_count> calibration_directions`.
+ * - `static constexpr double` motor_torque_constant (Nm/A),
+ *   joint_gear_ratio, motor_inertia (kg m^2), motor_max_current (A),
+ *   max_joint_velocity (rad/s), safety_damping (Nm s/rad), calibration_kp,
+ *   calibration_kd, calibration_duration (s) and calibration_dt (s).
+ * - `static constexpr std::array<long, 3> imu_rotate_vector` and
+ *   `std::array<long, 4> imu_orientation_vector`.
+ * - `static const char* default_serial_port()`, the slider box port used
+ *   when none is given, empty for none.
+ *
+ * @tparam Traits Compile time description of the robot, e.g. Solo12Traits.
+ */
+template <class Traits>
+class SoloRobot
+{
+public:
+    /** @brief Number of joints. */
+    static constexpr int joint_count = Traits::joint_count;
+    /** @brief Number of motor driver boards. */
+    static constexpr int motor_board_count = Traits::motor_board_count;
+
+    /** @brief Fixed size vector with one entry per joint. */
+    typedef Eigen::Matrix<double, joint_count, 1> JointVector;
+    /** @brief Sensor frame published at every acquire_sensors(). */
+    typedef SensorFrame<joint_count, motor_board_count> Frame;
+    /** @brief Record of one control cycle, see set_flight_recorder(). */
+    typedef FlightRecord<joint_count, motor_board_count> Record;
+    /** @brief Flight recorder fed by the robot. */
+    typedef FlightRecorder<Record> Recorder;
+    /** @brief Master board backend driving the robot. */
+    typedef MasterBoardBackend<joint_count, motor_board_count> Backend;
+    /** @brief Description of the robot for the master board backends. */
+    typedef MasterBoardBackendConfig<joint_count> BackendConfig;
+
+    /** @brief Persistent calibration, see enable_calibration_cache(). */
+    typedef CalibrationCache<joint_count> Cache;
+
+    /** @brief Scripted motion, see start_motion_sequence(). */
+    typedef MotionSequence<joint_count> Sequence;
+
+    /**
+     * @brief SoloRobot is the constructor of the class.
+     */
+    SoloRobot();
+
+    /**
+     * @brief Initialize the robot by setting aligning the motors and calibrate
+     * the sensors to 0.
+     * @param network_id Interface for connection to hardware, or "fake" to
+     * run on an emulated master board (FakeMasterBoardBackend).
+     * @param serial_port Serial port of the slider box, empty to disable it.
+     * Ignored with the "fake" network_id.
+     */
+    void initialize(
+        const std::string& network_id,
+        const std::string& serial_port = Traits::default_serial_port());
+
+    /**
+     * @brief Initialize the robot on the given master board backend.
+     * @param backend Backend created from get_backend_config().
+     * @param serial_port Serial port of the slider box, empty to disable it.
+     */
+    void initialize(std::shared_ptr<Backend> backend,
+                    const std::string& serial_port = "");
+
+    /**
+     * @brief Exchange the master board packets on a dedicated I/O thread.
+     *
+     * The I/O thread keeps parsing the incoming packets and sends the
+     * commands committed by send_target_joint_torque(), so acquire_sensors()
+     * returns the freshest frame without waiting on the network. See
+     * PipelinedMasterBoardBackend. Must be called before initialize().
+     *
+     * @param enabled
+     * @param parse_period Period of the parsing of the incoming packets (s).
+     */
+    void set_pipelined_acquisition(bool enabled, double parse_period = 0.00025);
+
+    /**
+     * @brief get_backend_config
+     * @param network_id Interface for connection to hardware.
+     * @return The description of the robot used to create the backends.
+     */
+    static BackendConfig get_backend_config(const std::string& network_id);
+
+    /**
+     * @brief Sets the maximum joint torques.
+     */
+    void set_max_current(const double& max_current);
+
+    /**
+     * @brief Wait that the robot enters into the ready states.
+     */
+    void wait_until_ready();
+
+    /**
+     * @brief Check if the robot is ready.
+     */
+    bool is_ready();
+
+    /**
+     * @brief send_target_torques sends the target currents to the motors.
+     */
+    void send_target_joint_torque(
+        const Eigen::Ref<const JointVector> target_joint_torque);
+
+    /**
+     * @brief acquire_sensors acquire all available sensors, WARNING !!!!
+     * this method has to be called prior to any getter to have up to date data.
+     *
+     * Neither this method nor send_target_joint_torque() and
+     * request_calibration() allocate, checked by an AllocationGuard in debug
+     * builds.
+     */
+    void acquire_sensors();
+
+    /**
+     * @brief Asynchronously request for the calibration.
+     *
+     * @param home_offset_rad This is the angle between the index and the zero
+     * pose.
+     * @return true in case of success.
+     * @return false in case of failure.
+     */
+    bool request_calibration(const JointVector& home_offset_rad);
+
+    /**
+     * @brief Persist the calibration across restarts.
+     *
+     * Loads the cache written by a previous run. When the next
+     * request_calibration() uses the cached home offsets and the motor
+     * boards still report all the encoder indexes as detected, i.e. they
+     * were not power cycled since, the offsets are restored without any
+     * motion. The calibration is accepted if, after a few cycles, every
+     * joint is within its limits, whatever the pose the robot was left in.
+     * Otherwise the full index search runs as before.
+     *
+     * The home offsets are posted to the cache as soon as a full
+     * calibration succeeds, and written to the file by its background
+     * thread. Does file I/O, never call it from the real time loop.
+     *
+     * @param file_path Path of the cache, see Cache::get_default_path().
+     * @return true if a cache for this robot was loaded.
+     */
+    bool enable_calibration_cache(const std::string& file_path =
+                                      Cache::get_default_path(Traits::name));
+
+    /**
+     * @brief Write the current calibration to the cache now, if it is
+     * enabled and the robot is calibrated. Does file I/O, never call it from
+     * the real time loop.
+     *
+     * @return true if the cache was written.
+     */
+    bool save_calibration_cache();
+
+    /**
+     * @brief If the last calibration was restored from the cache instead of
+     * searching the indexes.
+     */
+    bool is_calibration_restored() const
+    {
+        return is_calibration_restored_;
+    }
+
+    /**
+     * Joint properties
+     */
+
+    /**
+     * @brief get_motor_inertias in [kg m^2]
+     * @return Motor inertias.
+     */
+    const Eigen::Ref<JointVector> get_motor_inertias()
+    {
+        return motor_inertias_;
+    }
+
+    /**
+     * @brief get_motor_torque_constants in []
+     * @return Torque constants of each motor.
+     */
+    const Eigen::Ref<JointVector> get_motor_torque_constants()
+    {
+        return motor_torque_constants_;
+    }
+
+    /**
+     * @brief get_joint_gear_ratios
+     * @return Joint gear ratios
+     */
+    const Eigen::Ref<JointVector> get_joint_gear_ratios()
+    {
+        return joint_gear_ratios_;
+    }
+
+    /**
+     * @brief get_max_torque
+     * @return the max current of the motors, see Traits::motor_max_current.
+     */
+    const Eigen::Ref<JointVector> get_motor_max_current()
+    {
+        return motor_max_current_;
+    }
+
+    /**
+     * Sensor Data
+     */
+
+    /**
+     * @brief get_joint_positions
+     * @return  the joint angle of each module
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<JointVector> get_joint_positions()
+    {
+        return joint_positions_;
+    }
+
+    /**
+     * @brief get_joint_velocities
+     * @return the joint velocities
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<JointVector> get_joint_velocities()
+    {
+        return joint_velocities_;
+    }
+
+    /**
+     * @brief get_joint_torques
+     * @return the joint torques
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<JointVector> get_joint_torques()
+    {
+        return joint_torques_;
+    }
+
+    /**
+     * @brief get_joint_torques
+     * @return the target joint torques
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<JointVector> get_joint_target_torques()
+    {
+        return joint_target_torques_;
+    }
+
+    /**
+     * @brief get_joint_encoder_index
+     * @return the position of the index of the encoders a the motor level
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<JointVector> get_joint_encoder_index()
+    {
+        return joint_encoder_index_;
+    }
+
+    /*
+     * Additional data
+     */
+
+    /**
+     * @brief get_contact_sensors_states
+     * @return the state of the contacts states
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector4d> get_contact_sensors_states()
+    {
+        return contact_sensors_states_;
+    }
+
+    /**
+     * @brief get_slider_positions
+     * @return the current sliders positions.
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector4d> get_slider_positions()
+    {
+        return slider_positions_;
+    }
+
+    /**
+     * @brief get_slider_positions_age
+     * @return the age of the slider and E-Stop data at the last
+     * acquire_sensors() (s). Counted from the start of the reader while no
+     * frame was received, 0 without slider box.
+     */
+    double get_slider_positions_age() const
+    {
+        return slider_positions_age_;
+    }
+
+    /**
+     * @brief is_slider_stale
+     * @return true if the slider box stopped sending according to the
+     * staleness policy, see set_slider_staleness_policy().
+     */
+    bool is_slider_stale() const
+    {
+        return slider_stale_;
+    }
+
+    /**
+     * @brief Set when the slider data is considered stale and whether this
+     * activates the soft E-Stop.
+     * @param policy
+     */
+    void set_slider_staleness_policy(const SliderStalenessPolicy& policy)
+    {
+        slider_staleness_policy_ = policy;
+    }
+
+    /** @brief base accelerometer from imu.
+     * @return
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_accelerometer()
+    {
+        return imu_accelerometer_;
+    }
+
+    /** @brief base gyroscope from imu.
+     * @return
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_gyroscope()
+    {
+        return imu_gyroscope_;
+    }
+
+    /** @brief base attitude from imu.
+     * @return
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_attitude()
+    {
+        return imu_attitude_;
+    }
+
+    /** @brief base linear acceleration from imu.
+     * @return
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector3d> get_imu_linear_acceleration()
+    {
+        return imu_linear_acceleration_;
+    }
+
+    /** @brief base attitude quaternion (ordered {x, y, z, w}) from imu.
+     * @return
+     * WARNING !!!!
+     * The method <acquire_sensors>"()" has to be called
+     * prior to any getter to have up to date data.
+     */
+    const Eigen::Ref<Eigen::Vector4d> get_imu_attitude_quaternion()
+    {
+        return imu_attitude_quaternion_;
+    }
+
+    /*
+     * Hardware Status
+     */
+
+    /**
+     * @brief get_motor_enabled
+     * @return This gives the status (enabled/disabled) of each motors using the
+     * joint ordering convention.
+     */
+    const std::array<bool, joint_count>& get_motor_enabled()
+    {
+        return motor_enabled_;
+    }
+
+    /**
+     * @brief get_motor_ready
+     * @return This gives the status (enabled/disabled) of each motors using the
+     * joint ordering convention.
+     */
+    const std::array<bool, joint_count>& get_motor_ready()
+    {
+        return motor_ready_;
+    }
+
+    /**
+     * @brief get_motor_board_enabled
+     * @return This gives the status (enabled/disabled of the onboard control
+     * cards).
+     */
+    const std::array<bool, motor_board_count>& get_motor_board_enabled()
+    {
+        return motor_board_enabled_;
+    }
+
+    /**
+     * @brief get_motor_board_errors
+     * @return This gives the status (enabled/disabled of the onboard control
+     * cards).
+     */
+    const std::array<int, motor_board_count>& get_motor_board_errors()
+    {
+        return motor_board_errors_;
+    }
+
+    /**
+     * @brief has_error
+     * @return Returns true if the robot hardware has an error, false otherwise.
+     */
+    bool has_error() const
+    {
+        return backend_->has_error();
+    }
+
+    /**
+     * @brief is_calibrating()
+     * @return Returns true if the calibration procedure is running right now.
+     */
+    bool is_calibrating()
+    {
+        return _is_calibrating;
+    }
+
+    /**
+     * @brief Run a motion sequence in place of the user torques.
+     *
+     * From the next send_target_joint_torque() on, the torques of the
+     * sequence are sent, one tick per call, and the given torques are
+     * ignored until the sequence ends or stop_motion_sequence() is called.
+     * The sequence advances by its control period at each call, so it must
+     * be the period of the loop. A sequence already running is stopped.
+     * Must be called from the control thread.
+     *
+     * @param sequence Scripted phases, not copied: it must outlive the run.
+     * @return false if the robot is not ready, e.g. calibrating.
+     */
+    bool start_motion_sequence(Sequence& sequence)
+    {
+        if (state_ != SoloState::ready || calibrate_request_)
+        {
+            return false;
+        }
+        stop_motion_sequence();
+        sequence.start(joint_positions_);
+        motion_sequence_ = &sequence;
+        return true;
+    }
+
+    /**
+     * @brief Give the torques back to the user, the sequence stops where it
+     * is.
+     */
+    void stop_motion_sequence()
+    {
+        if (motion_sequence_ != nullptr)
+        {
+            motion_sequence_->stop();
+            motion_sequence_ = nullptr;
+        }
+    }
+
+    /** @brief If a motion sequence drives the joints. */
+    bool is_motion_sequence_running() const
+    {
+        return motion_sequence_ != nullptr;
+    }
+
+    /*
+     * Timing statistics
+     */
+
+    /**
+     * @brief get_timing_statistics
+     * @return The duration histograms of the phases of acquire_sensors() and
+     * send_target_joint_torque(), @see SoloTimingPhase.
+     */
+    const SoloTimingStatistics& get_timing_statistics() const
+    {
+        return timing_statistics_;
+    }
+
+    /**
+     * @brief Clear all the recorded durations.
+     */
+    void reset_timing_statistics()
+    {
+        timing_statistics_.reset();
+    }
+
+    /**
+     * @brief Set the time budget of one phase. Every call longer than the
+     * budget is counted as an overrun.
+     *
+     * @param phase The monitored phase.
+     * @param budget_sec (s)
+     */
+    void set_timing_budget(SoloTimingPhase phase, double budget_sec)
+    {
+        timing_statistics_.set_overrun_threshold_ns(
+            phase, static_cast<uint64_t>(budget_sec * 1e9));
+    }
+
+    /*
+     * Thread safe access to the sensor data
+     */
+
+    /**
+     * @brief Copy the latest sensor frame published by acquire_sensors().
+     *
+     * This can be called from any thread while the control loop is running.
+     * It never blocks the control loop, see SeqLock.
+     *
+     * @param[out] frame The latest complete sensor frame.
+     * @return uint64_t The number of frames published so far.
+     */
+    uint64_t read_sensor_frame(Frame& frame) const
+    {
+        return sensor_frame_publisher_.read(frame);
+    }
+
+    /**
+     * @brief get_sensor_frame_version
+     * @return The number of frames published so far. Thread safe.
+     */
+    uint64_t get_sensor_frame_version() const
+    {
+        return sensor_frame_publisher_.get_version();
+    }
+
+    /**
+     * @brief Record every control cycle into the given flight recorder.
+     *
+     * At each send_target_joint_torque() the latest sensor frame and the
+     * commanded torques are queued to the recorder. Set nullptr to stop
+     * recording. Must not be called while the control loop is running.
+     *
+     * @param flight_recorder
+     */
+    void set_flight_recorder(std::shared_ptr<Recorder> flight_recorder)
+    {
+        flight_recorder_ = flight_recorder;
+    }
+
+private:
+    /** @brief Cycles before checking a restored calibration. */
+    static constexpr int calibration_check_cycle_count = 10;
+
+    /**
+     * @brief Publish the current sensor data to the other threads.
+     */
+    void publish_sensor_frame();
+
+    /**
+     * @brief If the joint positions with the restored offsets are within
+     * the joint limits.
+     */
+    bool is_restored_calibration_consistent() const;
+
+    /**
+     * Joint properties
+     */
+
+    /** @brief Motors inertia. */
+    JointVector motor_inertias_;
+    /** @brief DCM motor torque constants. */
+    JointVector motor_torque_constants_;
+    /** @brief joint gear ratios (9). */
+    JointVector joint_gear_ratios_;
+    /** @brief Max appliable current before the robot shutdown. */
+    JointVector motor_max_current_;
+
+    /**
+     * -------------------------------------------------------------------------
+     * Hardware status
+     */
+
+    /**
+     * @brief This gives the status (enabled/disabled) of each motors using the
+     * joint ordering convention.
+     */
+    std::array<bool, joint_count> motor_enabled_;
+
+    /**
+     * @brief This gives the status (enabled/disabled) of each motors using the
+     * joint ordering convention.
+     */
+    std::array<bool, joint_count> motor_ready_;
+
+    /**
+     * @brief This gives the status
+     * (enabled/disabled of the onboard control cards).
+     */
+    std::array<bool, motor_board_count> motor_board_enabled_;
+
+    /**
+     * @brief This gives the status
+     * (enabled/disabled of the onboard control cards).
+     */
+    std::array<int, motor_board_count> motor_board_errors_;
+
+    /**
+     * Joint data
+     */
+
+    /**
+     * @brief joint_positions_
+     */
+    JointVector joint_positions_;
+    /**
+     * @brief joint_velocities_
+     */
+    JointVector joint_velocities_;
+    /**
+     * @brief joint_torques_
+     */
+    JointVector joint_torques_;
+    /**
+     * @brief joint_target_torques_
+     */
+    JointVector joint_target_torques_;
+    /**
+     * @brief joint_encoder_index_
+     */
+    JointVector joint_encoder_index_;
+
+    /**
+     * -------------------------------------------------------------------------
+     * Additional data
+     */
+
+    /**
+     * @brief slider_positions_ is the position of the linear potentiometer.
+     * Can be used as a joystick input.
+     */
+    Eigen::Vector4d slider_positions_;
+
+    /**
+     * @brief Latest raw frame of the slider box.
+     */
+    SliderBoxReader::Sample slider_sample_;
+
+    /** @brief Age of slider_sample_ at the last acquire_sensors() (s). */
+    double slider_positions_age_;
+
+    /** @brief If the slider box stopped sending. */
+    bool slider_stale_;
+
+    /** @brief When the slider data is stale and what to do then. */
+    SliderStalenessPolicy slider_staleness_policy_;
+
+    /**
+     * @brief contact_sensors_ is contact sensors at each feet of teh quadruped.
+     */
+    Eigen::Vector4d contact_sensors_states_;
+
+    /** @brief base accelerometer. */
+    Eigen::Vector3d imu_accelerometer_;
+
+    /** @brief base accelerometer. */
+    Eigen::Vector3d imu_gyroscope_;
+
+    /** @brief base accelerometer. */
+    Eigen::Vector3d imu_attitude_;
+
+    /** @brief base accelerometer. */
+    Eigen::Vector3d imu_linear_acceleration_;
+
+    /** @brief base attitude quaternion. */
+    Eigen::Vector4d imu_attitude_quaternion_;
+
+    /** @brief State of the solo robot. */
+    SoloState state_;
+
+    /** @brief Indicator if calibration should start. */
+    bool calibrate_request_;
+
+    /** @brief Home offsets of the requested calibration (rad). */
+    JointVector calibration_offsets_;
+
+    /** @brief If a calibration completed, or was restored. */
+    bool is_calibrated_;
+
+    /** @brief If the last calibration was restored from the cache. */
+    bool is_calibration_restored_;
+
+    /** @brief Cycles spent in SoloState::calibration_check. */
+    int calibration_check_cycles_;
+
+    /** @brief Persistent calibration, null when disabled. */
+    std::unique_ptr<Cache> calibration_cache_;
+
+    /**
+     * Drivers communication objects
+     */
+
+    /**
+     * @brief Main board drivers.
+     *
+     * PC <- Ethernet/Wifi -> main board <- SPI -> Motor Board
+     */
+    std::shared_ptr<Backend> backend_;
+
+    /**
+     * @brief Reader for serial port to read arduino slider values.
+     */
+    std::shared_ptr<SliderBoxReader> serial_reader_;
+
+    /** @brief If the packets are exchanged on a dedicated I/O thread. */
+    bool pipelined_acquisition_;
+
+    /** @brief Parse period of the pipelined acquisition (s). */
+    double pipelined_parse_period_;
+
+    /** @brief If the physical estop is pressed or not. */
+    bool active_estop_;
+
+    /** @brief Number of cycles with the estop active, to throttle the
+     * messages. */
+    long int estop_counter_;
+
+    /** @brief If the joint calibration is active or not. */
+    bool _is_calibrating;
+
+    /** @brief Durations of the phases of the control cycle. */
+    SoloTimingStatistics timing_statistics_;
+
+    /** @brief Staging frame filled at every acquire_sensors(). */
+    Frame sensor_frame_;
+
+    /** @brief Lock free publisher of the latest sensor frame. */
+    SeqLock<Frame> sensor_frame_publisher_;
+
+    /** @brief Optional recorder of every control cycle. */
+    std::shared_ptr<Recorder> flight_recorder_;
+
+    /** @brief Running motion sequence, null when none. */
+    Sequence* motion_sequence_;
+
+    /** @brief Torques of the running motion sequence (Nm). */
+    JointVector motion_sequence_torques_;
+
+    /** @brief Record filled at every send_target_joint_torque(). */
+    Record flight_record_;
+};
+
+template <class Traits>
+SoloRobot<Traits>::SoloRobot()
+{
+    /**
+     * Hardware properties
+     */
+    motor_inertias_.fill(Traits::motor_inertia);
+    motor_torque_constants_.fill(Traits::motor_torque_constant);
+    joint_gear_ratios_.fill(Traits::joint_gear_ratio);
+    motor_max_current_.fill(Traits::motor_max_current);
+
+    /**
+     * Hardware status
+     */
+    motor_enabled_.fill(false);
+    motor_ready_.fill(false);
+    motor_board_enabled_.fill(false);
+    motor_board_errors_.fill(0);
+
+    /**
+     * Joint data
+     */
+    joint_positions_.setZero();
+    joint_velocities_.setZero();
+    joint_torques_.setZero();
+    joint_target_torques_.setZero();
+    joint_encoder_index_.setZero();
+
+    /**
+     * Additional data
+     */
+    slider_positions_.setZero();
+    slider_positions_age_ = 0.0;
+    slider_stale_ = false;
+    contact_sensors_states_.setZero();
+    imu_accelerometer_.setZero();
+    imu_gyroscope_.setZero();
+    imu_attitude_.setZero();
+    imu_linear_acceleration_.setZero();
+    imu_attitude_quaternion_.setZero();
+    imu_attitude_quaternion_(3) = 1.0;
+
+    // By default assume the estop is inactive.
+    active_estop_ = false;
+    estop_counter_ = 0;
+    calibrate_request_ = false;
+    calibration_offsets_.setZero();
+    is_calibrated_ = false;
+    is_calibration_restored_ = false;
+    calibration_check_cycles_ = 0;
+    _is_calibrating = false;
+    pipelined_acquisition_ = false;
+    pipelined_parse_period_ = 0.00025;
+    motion_sequence_ = nullptr;
+    motion_sequence_torques_.setZero();
+
+    state_ = SoloState::initial;
+
+    // By default a full control cycle has to fit in 1ms.
+    set_timing_budget(timing_acquire_sensors, 0.001);
+    set_timing_budget(timing_send_target_joint_torque, 0.001);
+}
+
+template <class Traits>
+typename SoloRobot<Traits>::BackendConfig SoloRobot<Traits>::get_backend_config(
+    const std::string& network_id)
+{
+    BackendConfig config;
+    config.network_id = network_id;
+    config.motor_numbers = Traits::motor_numbers;
+    config.motor_reversed = Traits::motor_reversed;
+    config.motor_torque_constant = Traits::motor_torque_constant;
+    config.joint_gear_ratio = Traits::joint_gear_ratio;
+    config.motor_max_current = Traits::motor_max_current;
+    for (int i = 0; i < joint_count; ++i)
+    {
+        config.joint_lower_limits(i) = Traits::joint_lower_limits[i];
+        config.joint_upper_limits(i) = Traits::joint_upper_limits[i];
+    }
+    config.max_joint_velocity = Traits::max_joint_velocity;
+    config.safety_damping = Traits::safety_damping;
+    config.imu_rotate_vector = Traits::imu_rotate_vector;
+    config.imu_orientation_vector = Traits::imu_orientation_vector;
+    config.calibration_directions = Traits::calibration_directions;
+    config.calibration_kp = Traits::calibration_kp;
+    config.calibration_kd = Traits::calibration_kd;
+    config.calibration_duration = Traits::calibration_duration;
+    config.calibration_dt = Traits::calibration_dt;
+    return config;
+}
+
+template <class Traits>
+void SoloRobot<Traits>::initialize(const std::string& network_id,
+                                   const std::string& serial_port)
+{
+    BackendConfig config = get_backend_config(network_id);
+    config.motor_torque_constant = motor_torque_constants_(0);
+    config.joint_gear_ratio = joint_gear_ratios_(0);
+    config.motor_max_current = motor_max_current_(0);
+
+    if (network_id == "fake")
+    {
+        initialize(std::make_shared<
+                       FakeMasterBoardBackend<joint_count, motor_board_count> >(
+                       config),
+                   "");
+    }
+    else
+    {
+        initialize(std::make_shared<
+                       OdriMasterBoardBackend<joint_count, motor_board_count> >(
+                       config),
+                   serial_port);
+    }
+}
+
+template <class Traits>
+void SoloRobot<Traits>::set_pipelined_acquisition(bool enabled,
+                                                  double parse_period)
+{
+    if (backend_)
+    {
+        throw std::runtime_error(
+            "SoloRobot::set_pipelined_acquisition must be called before "
+            "initialize.");
+    }
+    pipelined_acquisition_ = enabled;
+    pipelined_parse_period_ = parse_period;
+}
+
+template <class Traits>
+void SoloRobot<Traits>::initialize(std::shared_ptr<Backend> backend,
+                                   const std::string& serial_port)
+{
+    if (pipelined_acquisition_)
+    {
+        backend_ = std::make_shared<
+            PipelinedMasterBoardBackend<joint_count, motor_board_count> >(
+            backend, pipelined_parse_period_);
+    }
+    else
+    {
+        backend_ = backend;
+    }
+
+    // Use a serial port to read slider values.
+    if (!serial_port.empty())
+    {
+        serial_reader_ = std::make_shared<SliderBoxReader>(serial_port);
+    }
+
+    // Initialize the robot.
+    backend_->init();
+}
+
+template <class Traits>
+void SoloRobot<Traits>::acquire_sensors()
+{
+    SOLO_RT_ALLOCATION_GUARD("SoloRobot::acquire_sensors");
+
+    const SoloTimingStatistics::Clock::time_point acquire_start =
+        SoloTimingStatistics::now();
+
+    backend_->parse_sensor_data();
+
+    SoloTimingStatistics::Clock::time_point phase_start =
+        timing_statistics_.record(timing_parse_sensor_data, acquire_start);
+
+    /**
+     * Joint data
+     */
+    // acquire the joint position
+    joint_positions_ = backend_->get_joint_positions();
+    // acquire the joint velocities
+    joint_velocities_ = backend_->get_joint_velocities();
+    // acquire the joint torques
+    joint_torques_ = backend_->get_joint_measured_torques();
+    // acquire the target joint torques
+    joint_target_torques_ = backend_->get_joint_sent_torques();
+
+    // TODO: The index angle is not transmitted.
+    // joint_encoder_index_ = joints_.get_measured_index_angles();
+
+    phase_start = timing_statistics_.record(timing_joint_data, phase_start);
+
+    /**
+     * Additional data
+     */
+    // acquire the slider positions
+    if (serial_reader_)
+    {
+        serial_reader_->read(slider_sample_);
+        slider_positions_age_ =
+            SliderBoxReader::now() - slider_sample_.timestamp;
+        if (slider_sample_.count > 0)
+        {
+            for (unsigned i = 0; i < slider_positions_.size(); ++i)
+            {
+                // acquire the slider
+                slider_positions_(i) =
+                    double(slider_sample_.values[i + 1]) / 1024.;
+            }
+
+            // Active the estop if button is pressed or the estop was active
+            // before.
+            active_estop_ |= slider_sample_.values[0] == 0;
+        }
+
+        // The slider box stopped sending, or never started.
+        const bool slider_stale =
+            slider_positions_age_ >
+            (slider_sample_.count > 0
+                 ? slider_staleness_policy_.max_age
+                 : slider_staleness_policy_.startup_timeout);
+        if (slider_stale && !slider_stale_)
+        {
+            rt_printf("%s: no slider box data for %f s.\n",
+                      Traits::name,
+                      slider_positions_age_);
+        }
+        slider_stale_ = slider_stale;
+        active_estop_ |=
+            slider_stale_ && slider_staleness_policy_.trigger_estop;
+    }
+
+    if (active_estop_ && estop_counter_++ % 2000 == 0)
+    {
+        backend_->report_error("Soft E-Stop is active.");
+    }
+
+    phase_start = timing_statistics_.record(timing_slider_data, phase_start);
+
+    // acquire imu
+    imu_linear_acceleration_ = backend_->get_imu_linear_acceleration();
+    imu_accelerometer_ = backend_->get_imu_accelerometer();
+    imu_gyroscope_ = backend_->get_imu_gyroscope();
+    imu_attitude_ = backend_->get_imu_attitude();
+    imu_attitude_quaternion_ = backend_->get_imu_attitude_quaternion();
+
+    phase_start = timing_statistics_.record(timing_imu_data, phase_start);
+
+    /**
+     * The different status.
+     */
+
+    // motor board status
+    motor_board_errors_ = backend_->get_motor_board_errors();
+    motor_board_enabled_ = backend_->get_motor_board_enabled();
+
+    // motors status
+    motor_enabled_ = backend_->get_motor_enabled();
+    motor_ready_ = backend_->get_motor_ready();
+
+    timing_statistics_.record(timing_status_data, phase_start);
+
+    publish_sensor_frame();
+
+    timing_statistics_.record(timing_acquire_sensors, acquire_start);
+}
+
+template <class Traits>
+void SoloRobot<Traits>::publish_sensor_frame()
+{
+    sensor_frame_.cycle++;
+    sensor_frame_.timestamp = Frame::now();
+    sensor_frame_.joint_positions = joint_positions_;
+    sensor_frame_.joint_velocities = joint_velocities_;
+    sensor_frame_.joint_torques = joint_torques_;
+    sensor_frame_.joint_target_torques = joint_target_torques_;
+    sensor_frame_.joint_encoder_index = joint_encoder_index_;
+    sensor_frame_.slider_positions = slider_positions_;
+    sensor_frame_.contact_sensors_states = contact_sensors_states_;
+    sensor_frame_.imu_accelerometer = imu_accelerometer_;
+    sensor_frame_.imu_gyroscope = imu_gyroscope_;
+    sensor_frame_.imu_attitude = imu_attitude_;
+    sensor_frame_.imu_linear_acceleration = imu_linear_acceleration_;
+    sensor_frame_.imu_attitude_quaternion = imu_attitude_quaternion_;
+    sensor_frame_.motor_enabled = motor_enabled_;
+    sensor_frame_.motor_ready = motor_ready_;
+    sensor_frame_.motor_board_enabled = motor_board_enabled_;
+    sensor_frame_.motor_board_errors = motor_board_errors_;
+    sensor_frame_.active_estop = active_estop_;
+    sensor_frame_.is_ready = state_ == SoloState::ready;
+    sensor_frame_.is_calibrating = _is_calibrating;
+    sensor_frame_.has_error = backend_->has_error();
+    sensor_frame_publisher_.write(sensor_frame_);
+}
+
+template <class Traits>
+void SoloRobot<Traits>::set_max_current(const double& max_current)
+{
+    backend_->set_maximum_current(max_current);
+}
+
+template <class Traits>
+void SoloRobot<Traits>::send_target_joint_torque(
+    const Eigen::Ref<const JointVector> target_joint_torque)
+{
+    SOLO_RT_ALLOCATION_GUARD("SoloRobot::send_target_joint_torque");
+
+    const SoloTimingStatistics::Clock::time_point send_start =
+        SoloTimingStatistics::now();
+
+    // A motion sequence replaces the user torques until it ends.
+    const bool is_sequence_running =
+        motion_sequence_ != nullptr && state_ == SoloState::ready &&
+        motion_sequence_->step(
+            joint_positions_, joint_velocities_, motion_sequence_torques_);
+    if (is_sequence_running)
+    {
+        backend_->set_torques(motion_sequence_torques_);
+    }
+    else
+    {
+        // Ended, or interrupted by a calibration.
+        stop_motion_sequence();
+        backend_->set_torques(target_joint_torque);
+    }
+
+    switch (state_)
+    {
+        case SoloState::initial:
+            backend_->set_zero_commands();
+            if (!backend_->is_timeout() && !backend_->is_ack_msg_received())
+            {
+                backend_->send_init();
+            }
+            else if (!backend_->is_ready())
+            {
+                backend_->send_command();
+            }
+            else
+            {
+                state_ = SoloState::ready;
+            }
+            break;
+
+        case SoloState::ready:
+            if (calibrate_request_)
+            {
+                calibrate_request_ = false;
+                _is_calibrating = true;
+                backend_->set_zero_commands();
+                if (calibration_cache_ &&
+                    calibration_cache_->is_valid_for(calibration_offsets_) &&
+                    backend_->restore_calibration(calibration_offsets_))
+                {
+                    calibration_check_cycles_ = 0;
+                    state_ = SoloState::calibration_check;
+                }
+                else
+                {
+                    state_ = SoloState::calibrate;
+                }
+            }
+            backend_->send_command();
+            break;
+
+        case SoloState::calibrate:
+            if (backend_->run_calibration())
+            {
+                state_ = SoloState::ready;
+                _is_calibrating = false;
+                is_calibrated_ = true;
+                is_calibration_restored_ = false;
+                if (calibration_cache_)
+                {
+                    calibration_cache_->post(calibration_offsets_);
+                }
+            }
+            backend_->send_command();
+            break;
+
+        case SoloState::calibration_check:
+            backend_->set_zero_commands();
+            // Let the positions with the restored offsets come through.
+            if (++calibration_check_cycles_ >= calibration_check_cycle_count)
+            {
+                _is_calibrating = false;
+                if (is_restored_calibration_consistent())
+                {
+                    printf("%s: calibration restored from the cache.\n",
+                           Traits::name);
+                    state_ = SoloState::ready;
+                    is_calibrated_ = true;
+                    is_calibration_restored_ = true;
+                }
+                else
+                {
+                    printf("%s: the restored calibration puts joints out of "
+                           "their limits, searching the indexes.\n",
+                           Traits::name);
+                    backend_->set_calibration_offsets(calibration_offsets_);
+                    state_ = SoloState::calibrate;
+                    _is_calibrating = true;
+                }
+            }
+            backend_->send_command();
+            break;
+    }
+
+    if (flight_recorder_)
+    {
+        flight_record_.set(sensor_frame_, target_joint_torque);
+        flight_recorder_->record(flight_record_);
+    }
+
+    timing_statistics_.record(timing_send_target_joint_torque, send_start);
+}
+
+template <class Traits>
+void SoloRobot<Traits>::wait_until_ready()
+{
+    PeriodicExecutor executor(0.001);
+    executor.start();
+    while (state_ != SoloState::ready)
+    {
+        if (executor.get_cycle_count() % 200 == 0)
+        {
+            printf("%s::wait_until_ready Getting ready\n", Traits::name);
+        }
+        executor.wait();
+    }
+}
+
+template <class Traits>
+bool SoloRobot<Traits>::is_ready()
+{
+    return state_ == SoloState::ready;
+}
+
+template <class Traits>
+bool SoloRobot<Traits>::request_calibration(const JointVector& home_offset_rad)
+{
+    SOLO_RT_ALLOCATION_GUARD("SoloRobot::request_calibration");
+
+    printf("%s::request_calibration called\n", Traits::name);
+    backend_->set_calibration_offsets(home_offset_rad);
+    calibration_offsets_ = home_offset_rad;
+    calibrate_request_ = true;
+    return true;
+}
+
+template <class Traits>
+bool SoloRobot<Traits>::enable_calibration_cache(const std::string& file_path)
+{
+    // The wiring, the directions and the gear ratio define the meaning of
+    // the cached offsets.
+    uint64_t fingerprint = 14695981039346656037ull;
+    for (const char* c = Traits::name; *c != '\0'; ++c)
+    {
+        fingerprint = Cache::hash(fingerprint, c, 1);
+    }
+    const int joint_count_value = joint_count;
+    const double gear_ratio = Traits::joint_gear_ratio;
+    fingerprint = Cache::hash(
+        fingerprint, &joint_count_value, sizeof(joint_count_value));
+    fingerprint = Cache::hash(fingerprint, &gear_ratio, sizeof(gear_ratio));
+    for (int i = 0; i < joint_count; ++i)
+    {
+        const int motor_number = Traits::motor_numbers[i];
+        const bool motor_reversed = Traits::motor_reversed[i];
+        const int direction = Traits::calibration_directions[i];
+        fingerprint =
+            Cache::hash(fingerprint, &motor_number, sizeof(motor_number));
+        fingerprint =
+            Cache::hash(fingerprint, &motor_reversed, sizeof(motor_reversed));
+        fingerprint = Cache::hash(fingerprint, &direction, sizeof(direction));
+    }
+
+    calibration_cache_.reset(new Cache(file_path, Traits::name, fingerprint));
+    const bool loaded = calibration_cache_->load();
+    printf("%s: %s calibration cache %s\n",
+           Traits::name,
+           loaded ? "loaded the" : "no valid",
+           file_path.c_str());
+    return loaded;
+}
+
+template <class Traits>
+bool SoloRobot<Traits>::save_calibration_cache()
+{
+    if (!calibration_cache_ || !is_calibrated_ ||
+        state_ != SoloState::ready)
+    {
+        return false;
+    }
+    if (!calibration_cache_->save(calibration_offsets_))
+    {
+        printf("%s: could not write the calibration cache %s\n",
+               Traits::name,
+               calibration_cache_->get_file_path().c_str());
+        return false;
+    }
+    return true;
+}
+
+template <class Traits>
+bool SoloRobot<Traits>::is_restored_calibration_consistent() const
+{
+    // The boards kept the indexes of the cached calibration, so only a
+    // grossly wrong restore, e.g. other home offsets, is left to catch.
+    for (int i = 0; i < joint_count; ++i)
+    {
+        if (!std::isfinite(joint_positions_(i)) ||
+            joint_positions_(i) < Traits::joint_lower_limits[i] ||
+            joint_positions_(i) > Traits::joint_upper_limits[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace solo
@@ -14,10 +14,12 @@
 #include <Eigen/Eigen>
 #include <array>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 
 #include "blmc_drivers/devices/motor.hpp"
 #include "solo/common_header.hpp"
+#include "solo/master_board_io_threads.hpp"
 
 #include "master_board_sdk/defines.h"
 #include "master_board_sdk/master_board_interface.h"
@@ -29,8 +31,21 @@ namespace solo
 /**
  * @brief This class defines an interface to a collection of BLMC joints. It
  * creates a BLMCJointModule for every blmc_driver::MotorInterface provided.
+ *
+ * The conversions between the motor and the joint space only depend on the
+ * polarities, gear ratios and motor constants, so they are fused into one
+ * factor per joint at construction. Each conversion is then a single
+ * vectorized product over all the joints, without divisions.
+ *
+ * The joints may span several master boards, each one on its own network
+ * interface. The packets of all the boards are then exchanged concurrently by
+ * MasterBoardIoThreads and the joints are still presented as one fixed size
+ * vector, in the order given by the mapping.
+ *
+ * @tparam COUNT Number of joints.
+ * @tparam BOARD_COUNT Number of master boards.
  */
-template <int COUNT>
+template <int COUNT, int BOARD_COUNT = 1>
 class SpiJointModules
 {
 public:
@@ -40,8 +55,11 @@ public:
      */
     typedef Eigen::Matrix<double, COUNT, 1> Vector;
 
+    /** @brief The master boards, in board index order. */
+    typedef typename MasterBoardIoThreads<BOARD_COUNT>::Boards Boards;
+
     /**
-     * @brief Construct a new SpiJointModules object.
+     * @brief Construct a new SpiJointModules object on a single master board.
      */
     SpiJointModules(std::shared_ptr<MasterBoardInterface> robot_if,
                     std::array<int, COUNT>& motor_to_card_index,
@@ -51,20 +69,69 @@ public:
                     const Vector& zero_angles,
                     const Vector& max_currents,
                     std::array<bool, COUNT> reverse_polarities)
+        : SpiJointModules(Boards{{robot_if}},
+                          std::array<int, COUNT>{},
+                          motor_to_card_index,
+                          motor_to_card_port_index,
+                          motor_constants,
+                          gear_ratios,
+                          zero_angles,
+                          max_currents,
+                          reverse_polarities)
+    {
+        static_assert(BOARD_COUNT == 1,
+                      "Use the constructor taking one master board per "
+                      "board index.");
+    }
+
+    /**
+     * @brief Construct a new SpiJointModules object spanning several master
+     * boards.
+     *
+     * @param boards One master board interface per board index.
+     * @param motor_to_board_index Master board of each joint.
+     * @param motor_to_card_index Motor driver of each joint on its board.
+     * @param motor_to_card_port_index Port of each joint on its driver.
+     * @param motor_constants (Nm/A)
+     * @param gear_ratios
+     * @param zero_angles (rad)
+     * @param max_currents (A)
+     * @param reverse_polarities
+     */
+    SpiJointModules(const Boards& boards,
+                    const std::array<int, COUNT>& motor_to_board_index,
+                    const std::array<int, COUNT>& motor_to_card_index,
+                    const std::array<int, COUNT>& motor_to_card_port_index,
+                    const Vector& motor_constants,
+                    const Vector& gear_ratios,
+                    const Vector& zero_angles,
+                    const Vector& max_currents,
+                    std::array<bool, COUNT> reverse_polarities)
+        : io_threads_(new MasterBoardIoThreads<BOARD_COUNT>(boards))
     {
-        robot_if_ = robot_if;
+        boards_ = boards;
 
-        // Setup the motor vectores based on the card and port mapping.
+        // Setup the motor vectores based on the board, card and port
+        // mapping.
         for (int i = 0; i < COUNT; i++)
         {
+            int board_idx = motor_to_board_index[i];
             int driver_idx = motor_to_card_index[i];
+            if (board_idx < 0 || board_idx >= BOARD_COUNT || driver_idx < 0 ||
+                driver_idx >= N_SLAVES)
+            {
+                throw std::runtime_error(
+                    "SpiJointModules: joint mapped to an invalid master "
+                    "board or motor driver.");
+            }
+            MotorDriver& driver = boards_[board_idx]->motor_drivers[driver_idx];
             if (motor_to_card_port_index[i] == 0)
             {
-                motors_[i] = (robot_if->motor_drivers[driver_idx].motor1);
+                motors_[i] = driver.motor1;
             }
             else
             {
-                motors_[i] = (robot_if->motor_drivers[driver_idx].motor2);
+                motors_[i] = driver.motor2;
             }
 
             polarities_[i] = reverse_polarities[i] ? -1. : 1.;
@@ -75,9 +142,24 @@ public:
         zero_angles_ = zero_angles;
         max_currents_ = max_currents;
 
+        // Fused conversion factors.
+        current_per_torque_ = polarities_.cwiseQuotient(gear_ratios_)
+                                  .cwiseQuotient(motor_constants_);
+        torque_per_current_ = polarities_.cwiseProduct(gear_ratios_)
+                                  .cwiseProduct(motor_constants_);
+        joint_per_motor_angle_ = polarities_.cwiseQuotient(gear_ratios_);
+        max_torques_ = max_currents_.cwiseProduct(gear_ratios_)
+                           .cwiseProduct(motor_constants_);
+
+        motor_to_board_index_ = motor_to_board_index;
         motor_to_card_index_ = motor_to_card_index;
 
         index_angles_.fill(0.);
+        saw_index_.fill(false);
+        // Motors not read yet are at zero.
+        measured_angles_ = -zero_angles_;
+        measured_velocities_.setZero();
+        measured_torques_.setZero();
     }
 
     /**
@@ -87,16 +169,17 @@ public:
     {
         for (int i = 0; i < COUNT; i++)
         {
-            int driver_idx = motor_to_card_index_[i];
-            robot_if_->motor_drivers[driver_idx].motor1->SetCurrentReference(0);
-            robot_if_->motor_drivers[driver_idx].motor2->SetCurrentReference(0);
-            robot_if_->motor_drivers[driver_idx].motor1->Enable();
-            robot_if_->motor_drivers[driver_idx].motor2->Enable();
-            robot_if_->motor_drivers[driver_idx].EnablePositionRolloverError();
-            robot_if_->motor_drivers[driver_idx].SetTimeout(5);
-            robot_if_->motor_drivers[driver_idx].Enable();
+            MotorDriver& driver = boards_[motor_to_board_index_[i]]
+                                      ->motor_drivers[motor_to_card_index_[i]];
+            driver.motor1->SetCurrentReference(0);
+            driver.motor2->SetCurrentReference(0);
+            driver.motor1->Enable();
+            driver.motor2->Enable();
+            driver.EnablePositionRolloverError();
+            driver.SetTimeout(5);
+            driver.Enable();
         }
-        robot_if_->SendCommand();
+        io_threads_->send_command();
     }
 
     /**
@@ -137,29 +220,31 @@ public:
     }
 
     /**
-     * @brief Send the registered torques to all modules.
+     * @brief Send the registered torques to all modules, on all the master
+     * boards concurrently.
      */
     void send_torques()
     {
-        robot_if_->SendCommand();
+        io_threads_->send_command();
     }
 
     /**
      * @brief Updates the measurements based on the lastest package from
-     * the master board.
+     * the master boards, parsed concurrently.
      */
     void acquire_sensors()
     {
-        robot_if_->ParseSensorData();
+        io_threads_->parse_sensor_data();
+        get_measurements(
+            measured_angles_, measured_velocities_, measured_torques_);
 
         // Keep tack of the first recorded encoder.
-        Vector positions = get_measured_angles();
         for (int i = 0; i < COUNT; i++)
         {
             if (saw_index_[i] == false && motors_[i]->HasIndexBeenDetected())
             {
                 saw_index_[i] = true;
-                index_angles_[i] = positions(i);
+                index_angles_[i] = measured_angles_(i);
             }
         }
     }
@@ -171,15 +256,11 @@ public:
      */
     void set_torques(const Vector& desired_torques)
     {
-        Vector desired_current = polarities_.cwiseProduct(desired_torques)
-                                     .cwiseQuotient(gear_ratios_)
-                                     .cwiseQuotient(motor_constants_);
-
-        // Current clamping.
-        desired_current = desired_current.cwiseMin(max_currents_);
-        desired_current = desired_current.cwiseMax(-max_currents_);
-        // Vector desired_current;
-        // desired_current.setZero();
+        // Conversion and current clamping in one pass.
+        const Vector desired_current =
+            desired_torques.cwiseProduct(current_per_torque_)
+                .cwiseMin(max_currents_)
+                .cwiseMax(-max_currents_);
 
         for (std::size_t i = 0; i < motors_.size(); i++)
         {
@@ -194,8 +275,7 @@ public:
      */
     Vector get_max_torques()
     {
-        return max_currents_.cwiseProduct(gear_ratios_)
-            .cwiseProduct(motor_constants_);
+        return max_torques_;
     }
 
     /**
@@ -210,63 +290,65 @@ public:
         {
             torques(i) = motors_[i]->current_ref;
         }
-        torques = torques.cwiseProduct(polarities_)
-                      .cwiseProduct(gear_ratios_)
-                      .cwiseProduct(motor_constants_);
-        return torques;
+        return torques.cwiseProduct(torque_per_current_);
     }
 
     /**
-     * @brief Get the measured joint torques.
+     * @brief Get the joint torques measured by the last acquire_sensors().
      *
      * @return Vector (Nm)
      */
     Vector get_measured_torques() const
     {
-        Vector torques;
-        for (size_t i = 0; i < COUNT; i++)
-        {
-            torques(i) = motors_[i]->GetCurrent();
-        }
-        torques = torques.cwiseProduct(polarities_)
-                      .cwiseProduct(gear_ratios_)
-                      .cwiseProduct(motor_constants_);
-        return torques;
+        return measured_torques_;
     }
 
     /**
-     * @brief Get the measured joint angles.
+     * @brief Get the joint angles measured by the last acquire_sensors().
      *
      * @return Vector (rad)
      */
     Vector get_measured_angles() const
     {
-        Vector positions;
-        for (size_t i = 0; i < COUNT; i++)
-        {
-            positions(i) = motors_[i]->GetPosition();
-        }
-        positions =
-            positions.cwiseProduct(polarities_).cwiseQuotient(gear_ratios_) -
-            zero_angles_;
-        return positions;
+        return measured_angles_;
     }
 
     /**
-     * @brief Get the measured joint velocities.
+     * @brief Get the joint velocities measured by the last acquire_sensors().
      *
      * @return Vector (rad/s)
      */
     Vector get_measured_velocities() const
     {
-        Vector velocities;
+        return measured_velocities_;
+    }
+
+    /**
+     * @brief Read the joint angles, velocities and torques from the motors.
+     *
+     * The motors are read in a single pass into one buffer per quantity,
+     * then each quantity is converted for all the joints by one vectorized
+     * product. acquire_sensors() uses it to fill the measured getters.
+     *
+     * @param[out] positions (rad)
+     * @param[out] velocities (rad/s)
+     * @param[out] torques (Nm)
+     */
+    void get_measurements(Vector& positions,
+                          Vector& velocities,
+                          Vector& torques) const
+    {
         for (size_t i = 0; i < COUNT; i++)
         {
-            velocities(i) = motors_[i]->GetVelocity();
+            Motor* motor = motors_[i];
+            positions(i) = motor->GetPosition();
+            velocities(i) = motor->GetVelocity();
+            torques(i) = motor->GetCurrent();
         }
-        velocities =
-            velocities.cwiseProduct(polarities_).cwiseQuotient(gear_ratios_);
-        return velocities;
+        positions =
+            positions.cwiseProduct(joint_per_motor_angle_) - zero_angles_;
+        velocities = velocities.cwiseProduct(joint_per_motor_angle_);
+        torques = torques.cwiseProduct(torque_per_current_);
     }
 
     /**
@@ -277,6 +359,8 @@ public:
      */
     void set_zero_angles(const Vector& zero_angles)
     {
+        // The measured angles follow the new zero without a new reading.
+        measured_angles_ += zero_angles_ - zero_angles;
         zero_angles_ = zero_angles;
     }
     /**
@@ -307,17 +391,38 @@ private:
     Vector zero_angles_;
     Vector polarities_;
 
+    /** @brief polarity / (gear ratio * motor constant) (A/Nm). */
+    Vector current_per_torque_;
+    /** @brief polarity * gear ratio * motor constant (Nm/A). */
+    Vector torque_per_current_;
+    /** @brief polarity / gear ratio. */
+    Vector joint_per_motor_angle_;
+    /** @brief max current * gear ratio * motor constant (Nm). */
+    Vector max_torques_;
+
+    std::array<int, COUNT> motor_to_board_index_;
     std::array<int, COUNT> motor_to_card_index_;
 
     Vector index_angles_;
     std::array<bool, COUNT> saw_index_;
 
+    /** @brief Joint angles read by the last acquire_sensors() (rad). */
+    Vector measured_angles_;
+    /** @brief Joint velocities read by the last acquire_sensors() (rad/s). */
+    Vector measured_velocities_;
+    /** @brief Joint torques read by the last acquire_sensors() (Nm). */
+    Vector measured_torques_;
+
     /**
      * @brief Holds the motors in the joint order.
      */
     std::array<Motor*, COUNT> motors_;
 
-    std::shared_ptr<MasterBoardInterface> robot_if_;
+    /** @brief The master boards of the joints. */
+    Boards boards_;
+
+    /** @brief Exchange the packets with all the master boards. */
+    std::unique_ptr<MasterBoardIoThreads<BOARD_COUNT>> io_threads_;
 };
 
 }  // namespace solo
@@ -0,0 +1,115 @@
+/**
+ * @file spsc_ring.hpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Bounded single producer, single consumer lock free ring buffer.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace solo
+{
+/**
+ * @brief Fixed capacity queue between exactly one producer thread and one
+ * consumer thread.
+ *
+ * All the memory is allocated in the constructor. push() and pop() are wait
+ * free and cost one copy of the element, so the producer can be the real time
+ * thread. When the ring is full push() fails instead of blocking.
+ *
+ * @tparam T Type of the elements, must be default constructible and copy
+ * assignable.
+ */
+template <class T>
+class SpscRing
+{
+public:
+    /**
+     * @brief Construct a new SpscRing object.
+     *
+     * @param capacity Maximum number of elements, must be a power of two.
+     */
+    SpscRing(std::size_t capacity) : elements_(capacity), head_(0), tail_(0)
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        {
+            throw std::invalid_argument(
+                "SpscRing: the capacity must be a power of two.");
+        }
+        mask_ = capacity - 1;
+    }
+
+    /**
+     * @brief Append a copy of the element. Producer thread only.
+     *
+     * @param element
+     * @return true on success, false if the ring is full.
+     */
+    bool push(const T& element)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_)
+        {
+            return false;
+        }
+        elements_[head & mask_] = element;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element. Consumer thread only.
+     *
+     * @param[out] element Copy of the oldest element, valid on success.
+     * @return true on success, false if the ring is empty.
+     */
+    bool pop(T& element)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        element = elements_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of elements waiting in the ring. Only an estimate when
+     * called while the other thread is active.
+     */
+    std::size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) -
+               tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Maximum number of elements.
+     */
+    std::size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+private:
+    /** @brief Preallocated storage. */
+    std::vector<T> elements_;
+    /** @brief capacity - 1, used to wrap the indexes. */
+    std::size_t mask_;
+    /** @brief Index of the next element to write, owned by the producer. */
+    alignas(64) std::atomic<std::size_t> head_;
+    /** @brief Index of the next element to read, owned by the consumer. */
+    alignas(64) std::atomic<std::size_t> tail_;
+};
+
+}  // namespace solo
@@ -0,0 +1,122 @@
+/**
+ * @file allocation_guard.cpp
+ * @license License BSD-3-Clause
+ * @copyright Copyright (c) 2026, New York University and Max Planck
+ * Gesellschaft.
+ * @date 2026-10-16
+ *
+ * @brief Replacement of the global allocation functions reporting the
+ * allocations to the AllocationGuard. Linked into an executable through the
+ * solo_allocation_guard library.
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "solo/allocation_guard.hpp"
+
+namespace
+{
+void* allocate(std::size_t size)
+{
+    solo::AllocationGuard::on_allocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment)
+{
+    solo::AllocationGuard::on_allocation(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*))
+    {
+        align = sizeof(void*);
+    }
+    void* pointer = nullptr;
+    if (::posix_memalign(&pointer, align, size == 0 ? 1 : size) != 0)
+    {
+        return nullptr;
+    }
+    return pointer;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    void* pointer = allocate(size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = allocate(size, alignment);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
@@ -7,41 +7,49 @@
  * This file uses the Solo12 class in a small demo.
  */
 
-#include <mutex>
+#include <atomic>
 #include "solo/common_programs_header.hpp"
 #include "solo/solo12.hpp"
 
 using namespace solo;
 
+/**
+ * @brief Data shared between the main thread and the control loop.
+ *
+ * Only the control loop talks to the robot. The main thread reads the
+ * published sensor frames and posts requests through atomic flags, so it can
+ * never stall the real time thread.
+ */
 struct SharedContent{
     Solo12 robot;
-    std::mutex sc_mutex;
-    bool print_home_offset;
+    std::atomic_bool calibration_requested;
+    std::atomic_bool print_home_offset;
 };
 
 static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
 {
     SharedContent& shared_content = *(static_cast<SharedContent*>(robot_void_ptr));
     Solo12& robot = shared_content.robot;
-    std::mutex& sc_mutex = shared_content.sc_mutex;
-    bool& print_home_offset = shared_content.print_home_offset;
-    
+
     // Prints the home-offset angle.
     Vector12d twelve_zeros = Vector12d::Zero();
     long int count = 0;
-    real_time_tools::Spinner spinner;
-    spinner.set_period(0.001);
+    PeriodicExecutor executor(0.001);
+    executor.start();
     while (!CTRL_C_DETECTED)
     {
-        sc_mutex.lock();
         robot.acquire_sensors();
-        if (count % 200 == 0 && print_home_offset)
+        if (shared_content.calibration_requested.exchange(false))
+        {
+            robot.request_calibration(twelve_zeros);
+        }
+        if (count % 200 == 0 && shared_content.print_home_offset)
         {
             print_vector("Home offset angle [Rad]", -robot.get_joint_positions());
         }
+        ++count;
         robot.send_target_joint_torque(twelve_zeros);
-        sc_mutex.unlock();
-        spinner.spin();
+        executor.wait();
     }
 
     return THREAD_FUNCTION_RETURN_VALUE;
@@ -60,7 +68,7 @@ int main(int argc, char** argv)
     // Initialize the shared content.
     SharedContent shared_content;
     shared_content.robot.initialize(argv[1], "banana");
-    shared_content.sc_mutex.unlock();
+    shared_content.calibration_requested = false;
     shared_content.print_home_offset = false;
 
     // Start control thread
@@ -69,36 +77,35 @@ int main(int argc, char** argv)
     rt_printf("Controller is set up.\n");
 
     rt_printf("Wait until the robot is ready.\n");
-    bool robot_ready = false;
-    while (!robot_ready)
+    Solo12SensorFrame frame;
+    shared_content.robot.read_sensor_frame(frame);
+    while (!frame.is_ready && !CTRL_C_DETECTED)
     {
-        shared_content.sc_mutex.lock();
-        robot_ready = shared_content.robot.is_ready();
-        shared_content.sc_mutex.unlock();
         real_time_tools::Timer::sleep_sec(0.1);
+        shared_content.robot.read_sensor_frame(frame);
     }
 
     rt_printf("Robot is ready, press enter to launch the calibration.\n");
     char str[256];
     std::cin.get(str, 256);  // get c-string
 
-    // Calibrate the robot.
-    Vector12d twelve_zeros = Vector12d::Zero();
-    shared_content.sc_mutex.lock();
-    shared_content.robot.request_calibration(twelve_zeros);
-    shared_content.sc_mutex.unlock();
-
-    // print the home offset:
-    while (!robot_ready)
+    // Calibrate the robot: wait for the control loop to start the
+    // calibration and then for the calibration to finish.
+    shared_content.calibration_requested = true;
+    bool calibration_started = false;
+    while (!CTRL_C_DETECTED)
     {
-        shared_content.sc_mutex.lock();
-        robot_ready = shared_content.robot.is_ready();
-        shared_content.sc_mutex.unlock();
         real_time_tools::Timer::sleep_sec(0.1);
+        shared_content.robot.read_sensor_frame(frame);
+        calibration_started |= frame.is_calibrating;
+        if (calibration_started && !frame.is_calibrating)
+        {
+            break;
+        }
     }
-    shared_content.sc_mutex.lock();
+
+    // print the home offset:
     shared_content.print_home_offset = true;
-    shared_content.sc_mutex.unlock();
 
     // Wait until the application is killed.
     thread.join();
@@ -20,6 +20,8 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
     eight_zeros.fill(0.0);
     robot->request_calibration(eight_zeros);
 
+    PeriodicExecutor executor(0.001);
+    executor.start();
     long int count = 0;
     while (!CTRL_C_DETECTED)
     {
@@ -30,7 +32,7 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
         }
         ++count;
         robot->send_target_joint_torque(eight_zeros);
-        real_time_tools::Timer::sleep_sec(0.001);
+        executor.wait();
     }
 
     return THREAD_FUNCTION_RETURN_VALUE;
@@ -20,6 +20,8 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
     joint_index_to_zero.fill(0.0);
     robot.calibrate(joint_index_to_zero);
 
+    PeriodicExecutor executor(0.001);
+    executor.start();
     long int count = 0;
     while (!CTRL_C_DETECTED)
     {
@@ -29,7 +31,7 @@ static THREAD_FUNCTION_RETURN_TYPE control_loop(void* robot_void_ptr)
             print_vector("Joint Positions", robot.get_joint_positions());
         }
         ++count;
-        real_time_tools::Timer::sleep_sec(0.001);
+        executor.wait();
     }
 
     return THREAD_FUNCTION_RETURN_VALUE;
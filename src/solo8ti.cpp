@@ -1,10 +1,29 @@
 #include "solo/solo8ti.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "solo/periodic_executor.hpp"
 
 namespace solo
 {
 const double Solo8TI::max_joint_torque_security_margin_ = 0.99;
 
+// Maximum distance is twice the angle between joint indexes.
+const double Solo8TI::homing_search_distance_limit_ = 2.0 * (2.0 * M_PI / 9.0);
+const double Solo8TI::homing_step_size_ = 0.001;
+const double Solo8TI::homing_kp_ = 3.0;
+const double Solo8TI::homing_kd_ = 0.05;
+const double Solo8TI::homing_go_to_zero_velocity_ = 1.0;
+
+const std::array<const char*, 4> Solo8TI::can_bus_legs_ = {
+    {"FR", "HR", "HL", "FL"}};
+
 Solo8TI::Solo8TI()
 {
     /**
@@ -47,6 +66,23 @@ Solo8TI::Solo8TI()
      */
     slider_positions_.setZero();
     contact_sensors_states_.setZero();
+    bus_timestamps_.fill(std::numeric_limits<double>::quiet_NaN());
+    newest_bus_timestamp_ = std::numeric_limits<double>::quiet_NaN();
+    bus_skew_ = 0.0;
+    max_bus_skew_ = 0.0;
+    homing_state_ = homing_idle;
+    is_calibrated_ = false;
+    homing_offsets_.setZero();
+    homing_previous_zero_angles_.setZero();
+    homing_zero_angles_.setZero();
+    homing_targets_.setZero();
+    homing_start_positions_.setZero();
+    homing_index_found_.fill(false);
+    homing_index_time_indexes_.fill(-1);
+    homing_step_count_ = 0;
+    homing_go_to_zero_start_ = 0.0;
+    homing_go_to_zero_duration_ = 0.0;
+    is_can_telemetry_enabled_ = false;
 
     /**
      * Setup some known data
@@ -59,16 +95,13 @@ Solo8TI::Solo8TI()
     joint_gear_ratios_.fill(9.0);
 }
 
-void Solo8TI::initialize()
+void Solo8TI::initialize(double ready_timeout)
 {
-    // initialize the communication with the can cards
+    // initialize the communication with the can cards, all at once
+    std::array<double, 4> bring_up_durations;
+    bring_up_can_buses(bring_up_durations);
     for (unsigned i = 0; i < can_buses_.size(); ++i)
     {
-        std::ostringstream oss;
-        oss << "can" << i;
-        can_buses_[i] = std::make_shared<blmc_drivers::CanBus>(oss.str());
-        can_motor_boards_[i] =
-            std::make_shared<blmc_drivers::CanBusMotorBoard>(can_buses_[i]);
         sliders_[i] = std::make_shared<blmc_drivers::AnalogSensor>(
             can_motor_boards_[i], 1);
     }
@@ -149,19 +182,191 @@ void Solo8TI::initialize()
     joints_.set_position_control_gains(kp, kd);
 
     // wait until all board are ready and connected
+    wait_until_boards_ready(ready_timeout, bring_up_durations);
+}
+
+void Solo8TI::bring_up_can_buses(std::array<double, 4>& bring_up_durations)
+{
+    typedef std::chrono::steady_clock Clock;
+    std::array<std::thread, 4> threads;
+    std::array<std::exception_ptr, 4> errors;
     for (unsigned i = 0; i < can_buses_.size(); ++i)
     {
-        can_motor_boards_[i]->wait_until_ready();
+        threads[i] = std::thread([this, i, &bring_up_durations, &errors]() {
+            try
+            {
+                const Clock::time_point start = Clock::now();
+                std::ostringstream oss;
+                oss << "can" << i;
+                can_buses_[i] =
+                    std::make_shared<blmc_drivers::CanBus>(oss.str());
+                can_motor_boards_[i] =
+                    std::make_shared<blmc_drivers::CanBusMotorBoard>(
+                        can_buses_[i]);
+                bring_up_durations[i] =
+                    std::chrono::duration<double>(Clock::now() - start)
+                        .count();
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (unsigned i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    for (unsigned i = 0; i < errors.size(); ++i)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+}
+
+void Solo8TI::wait_until_boards_ready(
+    double ready_timeout, const std::array<double, 4>& bring_up_durations)
+{
+    std::array<bool, 4> is_board_ready;
+    is_board_ready.fill(false);
+    unsigned ready_count = 0;
+
+    PeriodicExecutor executor(0.001);
+    executor.start();
+    const double start = SensorFrame<8, 4>::now();
+    while (true)
+    {
+        const double elapsed = SensorFrame<8, 4>::now() - start;
+        for (unsigned i = 0; i < can_motor_boards_.size(); ++i)
+        {
+            if (!is_board_ready[i] && can_motor_boards_[i]->is_ready())
+            {
+                is_board_ready[i] = true;
+                ++ready_count;
+                printf("Solo8TI: can%u (%s) ready after %.3f s, bus opened "
+                       "in %.3f s.\n",
+                       i,
+                       can_bus_legs_[i],
+                       elapsed,
+                       bring_up_durations[i]);
+            }
+        }
+        if (ready_count == can_motor_boards_.size())
+        {
+            break;
+        }
+        if (elapsed > ready_timeout)
+        {
+            std::ostringstream message;
+            message << "Solo8TI::initialize: motor boards not ready after "
+                    << ready_timeout << " s:";
+            for (unsigned i = 0; i < can_motor_boards_.size(); ++i)
+            {
+                if (!is_board_ready[i])
+                {
+                    message << " can" << i << " (" << can_bus_legs_[i] << ")";
+                }
+            }
+            throw std::runtime_error(message.str());
+        }
+        executor.wait();
     }
 }
 
 void Solo8TI::acquire_sensors()
+{
+    // acquire the joint position
+    joint_positions_ = joints_.get_measured_angles();
+    read_sensors();
+    publish_sensor_frame();
+}
+
+void Solo8TI::acquire_sensors_snapshot(bool align_to_newest_bus)
+{
+    read_bus_snapshot();
+    read_sensors();
+
+    // Without any bus sample there is nothing to align to.
+    if (align_to_newest_bus && bus_skew_ > 0.0 &&
+        !std::isnan(newest_bus_timestamp_))
+    {
+        for (unsigned i = 0; i < motor_to_card_index_.size(); ++i)
+        {
+            const double bus_timestamp =
+                bus_timestamps_[motor_to_card_index_[i]];
+            if (!std::isnan(bus_timestamp))
+            {
+                joint_positions_(i) +=
+                    joint_velocities_(i) *
+                    (newest_bus_timestamp_ - bus_timestamp);
+            }
+        }
+    }
+    publish_sensor_frame();
+}
+
+void Solo8TI::read_bus_snapshot()
+{
+    typedef blmc_drivers::MotorBoardInterface mbi;
+    const Vector8d zero_angles = joints_.get_zero_angles();
+    double oldest_timestamp = std::numeric_limits<double>::infinity();
+    double newest_timestamp = -std::numeric_limits<double>::infinity();
+    for (unsigned i = 0; i < can_motor_boards_.size(); ++i)
+    {
+        // Both ports of a board are sampled by the same CAN frame, so the
+        // positions and the timestamp are all read at one time index.
+        const auto positions_0 =
+            can_motor_boards_[i]->get_measurement(mbi::position_0);
+        std::array<double, 2> positions;
+        if (positions_0->length() == 0)
+        {
+            bus_timestamps_[i] = std::numeric_limits<double>::quiet_NaN();
+            positions.fill(std::numeric_limits<double>::quiet_NaN());
+        }
+        else
+        {
+            const auto positions_1 =
+                can_motor_boards_[i]->get_measurement(mbi::position_1);
+            const long time_index =
+                positions_0->newest_timeindex(false);
+            bus_timestamps_[i] = positions_0->timestamp_s(time_index);
+            positions[0] = (*positions_0)[time_index];
+            positions[1] = (*positions_1)[time_index];
+            oldest_timestamp = std::min(oldest_timestamp, bus_timestamps_[i]);
+            newest_timestamp = std::max(newest_timestamp, bus_timestamps_[i]);
+        }
+
+        // Same conversion as BlmcJointModule::get_measured_angle().
+        for (unsigned j = 0; j < motor_to_card_index_.size(); ++j)
+        {
+            if (motor_to_card_index_[j] != static_cast<int>(i))
+            {
+                continue;
+            }
+            const double polarity = reverse_polarities_[j] ? -1.0 : 1.0;
+            joint_positions_(j) =
+                positions[motor_to_card_port_index_[j]] * 2.0 * M_PI /
+                    joint_gear_ratios_(j) * polarity -
+                zero_angles(j);
+        }
+    }
+    // The buses without sample are skipped, NaN if none has one.
+    newest_bus_timestamp_ = newest_timestamp >= oldest_timestamp
+                                ? newest_timestamp
+                                : std::numeric_limits<double>::quiet_NaN();
+    bus_skew_ = newest_timestamp > oldest_timestamp
+                    ? newest_timestamp - oldest_timestamp
+                    : 0.0;
+    max_bus_skew_ = std::max(max_bus_skew_, bus_skew_);
+}
+
+void Solo8TI::read_sensors()
 {
     /**
      * Joint data
      */
-    // acquire the joint position
-    joint_positions_ = joints_.get_measured_angles();
     // acquire the joint velocities
     joint_velocities_ = joints_.get_measured_velocities();
     // acquire the joint torques
@@ -233,26 +438,203 @@ void Solo8TI::acquire_sensors()
     motor_ready_[7] = static_cast<bool>(HR_status.motor1_ready);  // HR_KFE
 }
 
+void Solo8TI::publish_sensor_frame()
+{
+    sensor_frame_.cycle++;
+    sensor_frame_.timestamp = SensorFrame<8, 4>::now();
+    sensor_frame_.joint_positions = joint_positions_;
+    sensor_frame_.joint_velocities = joint_velocities_;
+    sensor_frame_.joint_torques = joint_torques_;
+    sensor_frame_.joint_target_torques = joint_target_torques_;
+    sensor_frame_.joint_encoder_index = joint_encoder_index_;
+    sensor_frame_.slider_positions = slider_positions_;
+    sensor_frame_.contact_sensors_states = contact_sensors_states_;
+    sensor_frame_.motor_enabled = motor_enabled_;
+    sensor_frame_.motor_ready = motor_ready_;
+    sensor_frame_.motor_board_enabled = motor_board_enabled_;
+    sensor_frame_.motor_board_errors = motor_board_errors_;
+    // The homing runs inside the control loop, the readers must see it.
+    sensor_frame_.is_calibrating = is_calibrating();
+    sensor_frame_.is_ready = !is_calibrating();
+    sensor_frame_publisher_.write(sensor_frame_);
+}
+
 void Solo8TI::send_target_joint_torque(
-    const Eigen::Ref<Vector8d> target_joint_torque)
+    const Eigen::Ref<const Vector8d> target_joint_torque)
 {
     Vector8d ctrl_torque = target_joint_torque;
+    if (homing_state_ != homing_idle)
+    {
+        update_homing(ctrl_torque);
+    }
     ctrl_torque = ctrl_torque.array().min(max_joint_torques_);
     ctrl_torque = ctrl_torque.array().max(-max_joint_torques_);
     joints_.set_torques(ctrl_torque);
     joints_.send_torques();
+
+    if (is_can_telemetry_enabled_)
+    {
+        const double now = Solo8TISensorFrame::now();
+        for (unsigned i = 0; i < can_bus_telemetry_.size(); ++i)
+        {
+            can_bus_telemetry_[i].update(now);
+        }
+    }
+
+    if (flight_recorder_)
+    {
+        flight_record_.set(sensor_frame_, target_joint_torque);
+        flight_recorder_->record(flight_record_);
+    }
 }
 
-bool Solo8TI::calibrate(const Vector8d& home_offset_rad)
+void Solo8TI::enable_can_telemetry(double bitrate)
 {
-    // Maximum distance is twice the angle between joint indexes
-    double search_distance_limit_rad = 2.0 * (2.0 * M_PI / 9.0);
-    Vector8d profile_step_size_rad = Vector8d::Constant(0.001);
-    joints_.execute_homing(
-        search_distance_limit_rad, home_offset_rad, profile_step_size_rad);
-    Vector8d zero_pose = Vector8d::Zero();
-    joints_.go_to(zero_pose);
+    for (unsigned i = 0; i < can_buses_.size(); ++i)
+    {
+        if (!can_buses_[i])
+        {
+            throw std::runtime_error(
+                "Solo8TI::enable_can_telemetry must be called after "
+                "initialize.");
+        }
+        can_bus_telemetry_[i].attach(can_buses_[i], bitrate);
+    }
+    is_can_telemetry_enabled_ = true;
+}
+
+bool Solo8TI::request_calibration(const Vector8d& home_offset_rad)
+{
+    printf("Solo8TI::request_calibration called\n");
+    homing_offsets_ = home_offset_rad;
+    homing_state_ = homing_start;
     return true;
 }
 
+bool Solo8TI::calibrate(const Vector8d& home_offset_rad)
+{
+    request_calibration(home_offset_rad);
+    const Vector8d zero_torques = Vector8d::Zero();
+    PeriodicExecutor executor(0.001);
+    executor.start();
+    while (is_calibrating())
+    {
+        acquire_sensors();
+        send_target_joint_torque(zero_torques);
+        executor.wait();
+    }
+    return is_calibrated_;
+}
+
+long Solo8TI::get_newest_index_time_index(int motor) const
+{
+    const auto index_angles = motors_[motor]->get_measurement(
+        blmc_drivers::MotorInterface::encoder_index);
+    return index_angles->length() == 0 ? -1
+                                       : index_angles->newest_timeindex(false);
+}
+
+void Solo8TI::update_homing(Vector8d& torques)
+{
+    switch (homing_state_)
+    {
+        case homing_idle:
+            return;
+
+        case homing_start:
+            // Search in the raw joint space, like BlmcJointModule homing.
+            homing_previous_zero_angles_ = joints_.get_zero_angles();
+            joints_.set_zero_angles(Vector8d::Zero());
+            homing_targets_ = joints_.get_measured_angles();
+            for (unsigned i = 0; i < motors_.size(); ++i)
+            {
+                homing_index_found_[i] = false;
+                homing_index_time_indexes_[i] = get_newest_index_time_index(i);
+            }
+            homing_step_count_ = 0;
+            is_calibrated_ = false;
+            torques.setZero();
+            homing_state_ = homing_search;
+            return;
+
+        case homing_search:
+        {
+            bool all_found = true;
+            for (unsigned i = 0; i < motors_.size(); ++i)
+            {
+                if (!homing_index_found_[i] &&
+                    get_newest_index_time_index(i) >
+                        homing_index_time_indexes_[i])
+                {
+                    homing_index_found_[i] = true;
+                    homing_zero_angles_(i) =
+                        joints_.get_measured_index_angles()(i) -
+                        homing_offsets_(i);
+                }
+                if (!homing_index_found_[i])
+                {
+                    homing_targets_(i) += homing_step_size_;
+                    all_found = false;
+                }
+            }
+            homing_step_count_++;
+            torques =
+                homing_kp_ * (homing_targets_ - joint_positions_) -
+                homing_kd_ * joint_velocities_;
+
+            if (all_found)
+            {
+                joints_.set_zero_angles(homing_zero_angles_);
+                joint_zero_positions_ = homing_zero_angles_;
+                homing_start_positions_ =
+                    joint_positions_ - homing_zero_angles_;
+                homing_go_to_zero_start_ = Solo8TISensorFrame::now();
+                homing_go_to_zero_duration_ =
+                    homing_start_positions_.cwiseAbs().maxCoeff() /
+                    homing_go_to_zero_velocity_;
+                homing_state_ = homing_go_to_zero;
+            }
+            else if (homing_step_count_ * homing_step_size_ >
+                     homing_search_distance_limit_)
+            {
+                printf("Solo8TI: homing failed, no index found within %f rad "
+                       "for the joints:",
+                       homing_search_distance_limit_);
+                for (unsigned i = 0; i < motors_.size(); ++i)
+                {
+                    if (!homing_index_found_[i])
+                    {
+                        printf(" %u", i);
+                    }
+                }
+                printf(".\n");
+                joints_.set_zero_angles(homing_previous_zero_angles_);
+                torques.setZero();
+                homing_state_ = homing_idle;
+            }
+            return;
+        }
+
+        case homing_go_to_zero:
+        {
+            const double elapsed =
+                Solo8TISensorFrame::now() - homing_go_to_zero_start_;
+            const double ratio =
+                homing_go_to_zero_duration_ > 0.0
+                    ? std::min(1.0, elapsed / homing_go_to_zero_duration_)
+                    : 1.0;
+            homing_targets_ = (1.0 - ratio) * homing_start_positions_;
+            torques = homing_kp_ * (homing_targets_ - joint_positions_) -
+                      homing_kd_ * joint_velocities_;
+            if (ratio >= 1.0)
+            {
+                printf("Solo8TI: homing done.\n");
+                is_calibrated_ = true;
+                homing_state_ = homing_idle;
+            }
+            return;
+        }
+    }
+}
+
 }  // namespace solo
@@ -16,14 +16,107 @@
  */
 
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl_bind.h>
 
+#include <solo/control_loop_runner.hpp>
 #include <solo/solo12.hpp>
 
 namespace py = pybind11;
 using namespace solo;
 
+/**
+ * @brief Read-only NumPy view over a buffer of the robot.
+ *
+ * The robot updates its buffers in place, so the view always shows the
+ * latest data: a Python controller can fetch it once and read it at every
+ * cycle without any copy. The view keeps the robot alive.
+ *
+ * @param data First element of the buffer.
+ * @param size Number of elements.
+ * @param owner Python object owning the buffer.
+ */
+template <class Scalar>
+py::array read_only_view(const Scalar* data,
+                         py::ssize_t size,
+                         py::handle owner)
+{
+    py::array_t<Scalar> array(
+        {size}, {py::ssize_t(sizeof(Scalar))}, data, owner);
+    py::detail::array_proxy(array.ptr())->flags &=
+        ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return array;
+}
+
+template <class Derived>
+py::array read_only_view(const Eigen::DenseBase<Derived>& vector,
+                         py::handle owner)
+{
+    return read_only_view(vector.derived().data(), vector.size(), owner);
+}
+
+template <class Scalar, std::size_t SIZE>
+py::array read_only_view(const std::array<Scalar, SIZE>& array,
+                         py::handle owner)
+{
+    return read_only_view(array.data(), py::ssize_t(SIZE), owner);
+}
+
+typedef ControlLoopRunner<Solo12> Solo12ControlLoopRunner;
+typedef Solo12ControlLoopRunner::Command Solo12JointCommand;
+
+/**
+ * @brief Python callable used as a ControlLoopRunner policy.
+ *
+ * Called from the policy thread: the GIL is taken for the call and for the
+ * release of the callable.
+ */
+struct PythonPolicy
+{
+    PythonPolicy(py::function function) : function(function)
+    {
+    }
+
+    ~PythonPolicy()
+    {
+        py::gil_scoped_acquire gil;
+        function = py::function();
+    }
+
+    void operator()(const Solo12SensorFrame& frame,
+                    Solo12JointCommand& command)
+    {
+        py::gil_scoped_acquire gil;
+        try
+        {
+            // The frame is copied so the policy may keep it, the command is
+            // filled in place.
+            function(py::cast(frame),
+                     py::cast(&command, py::return_value_policy::reference));
+        }
+        catch (py::error_already_set& error)
+        {
+            throw std::runtime_error(error.what());
+        }
+    }
+
+    py::function function;
+};
+
+/**
+ * @brief Delete the runner without the GIL, the policy thread may be waiting
+ * for it.
+ */
+struct GilReleasingDeleter
+{
+    void operator()(Solo12ControlLoopRunner* runner) const
+    {
+        py::gil_scoped_release release;
+        delete runner;
+    }
+};
+
 PYBIND11_MODULE(py_solo12, m)
 {
     // binding of stl containers
@@ -31,23 +124,307 @@ PYBIND11_MODULE(py_solo12, m)
     // py::bind_vector<std::vector<KinematicsState>>(m, "KinStateVector");
     // py::bind_vector<std::vector<Eigen::MatrixXd>>(m, "JacobianVector");
 
-    py::class_<Solo12>(m, "Solo12")
+    py::class_<LatencyHistogram>(m, "LatencyHistogram")
+        .def("get_percentile_ns",
+             &LatencyHistogram::get_percentile_ns,
+             py::arg("percentile"))
+        .def("get_p50_ns", &LatencyHistogram::get_p50_ns)
+        .def("get_p99_ns", &LatencyHistogram::get_p99_ns)
+        .def("get_p999_ns", &LatencyHistogram::get_p999_ns)
+        .def("get_min_ns", &LatencyHistogram::get_min_ns)
+        .def("get_max_ns", &LatencyHistogram::get_max_ns)
+        .def("get_mean_ns", &LatencyHistogram::get_mean_ns)
+        .def("get_count", &LatencyHistogram::get_count)
+        .def("get_overrun_count", &LatencyHistogram::get_overrun_count)
+        .def("get_overrun_threshold_ns",
+             &LatencyHistogram::get_overrun_threshold_ns);
+
+    py::enum_<Solo12TimingPhase>(m, "Solo12TimingPhase")
+        .value("parse_sensor_data", timing_parse_sensor_data)
+        .value("joint_data", timing_joint_data)
+        .value("slider_data", timing_slider_data)
+        .value("imu_data", timing_imu_data)
+        .value("status_data", timing_status_data)
+        .value("acquire_sensors", timing_acquire_sensors)
+        .value("send_target_joint_torque", timing_send_target_joint_torque);
+
+    py::class_<Solo12TimingStatistics>(m, "Solo12TimingStatistics")
+        .def(
+            "get_histogram",
+            [](const Solo12TimingStatistics& statistics,
+               Solo12TimingPhase phase) -> const LatencyHistogram& {
+                return statistics.get_histogram(phase);
+            },
+            py::return_value_policy::reference_internal,
+            py::arg("phase"));
+
+    py::class_<SliderStalenessPolicy>(m, "SliderStalenessPolicy")
+        .def(py::init<>())
+        .def_readwrite("max_age", &SliderStalenessPolicy::max_age)
+        .def_readwrite("startup_timeout",
+                       &SliderStalenessPolicy::startup_timeout)
+        .def_readwrite("trigger_estop", &SliderStalenessPolicy::trigger_estop);
+
+    py::class_<Solo12SensorFrame>(m, "Solo12SensorFrame")
+        .def(py::init<>())
+        .def_readonly("cycle", &Solo12SensorFrame::cycle)
+        .def_readonly("timestamp", &Solo12SensorFrame::timestamp)
+        .def_readonly("joint_positions", &Solo12SensorFrame::joint_positions)
+        .def_readonly("joint_velocities",
+                      &Solo12SensorFrame::joint_velocities)
+        .def_readonly("joint_torques", &Solo12SensorFrame::joint_torques)
+        .def_readonly("joint_target_torques",
+                      &Solo12SensorFrame::joint_target_torques)
+        .def_readonly("slider_positions",
+                      &Solo12SensorFrame::slider_positions)
+        .def_readonly("imu_accelerometer",
+                      &Solo12SensorFrame::imu_accelerometer)
+        .def_readonly("imu_gyroscope", &Solo12SensorFrame::imu_gyroscope)
+        .def_readonly("imu_attitude", &Solo12SensorFrame::imu_attitude)
+        .def_readonly("imu_linear_acceleration",
+                      &Solo12SensorFrame::imu_linear_acceleration)
+        .def_readonly("imu_attitude_quaternion",
+                      &Solo12SensorFrame::imu_attitude_quaternion)
+        .def_readonly("active_estop", &Solo12SensorFrame::active_estop)
+        .def_readonly("is_ready", &Solo12SensorFrame::is_ready)
+        .def_readonly("is_calibrating", &Solo12SensorFrame::is_calibrating)
+        .def_readonly("has_error", &Solo12SensorFrame::has_error);
+
+    py::class_<Solo12JointCommand>(m, "Solo12JointCommand")
+        .def(py::init<>())
+        .def_readwrite("positions", &Solo12JointCommand::positions)
+        .def_readwrite("velocities", &Solo12JointCommand::velocities)
+        .def_readwrite("torques", &Solo12JointCommand::torques)
+        .def_readwrite("kp", &Solo12JointCommand::kp)
+        .def_readwrite("kd", &Solo12JointCommand::kd)
+        .def_readonly("timestamp", &Solo12JointCommand::timestamp)
+        .def_readonly("sequence", &Solo12JointCommand::sequence);
+
+    py::class_<ControlLoopRunnerConfig>(m, "ControlLoopRunnerConfig")
+        .def(py::init<>())
+        .def_readwrite("control_period",
+                       &ControlLoopRunnerConfig::control_period)
+        .def_readwrite("policy_period", &ControlLoopRunnerConfig::policy_period)
+        .def_readwrite("command_timeout",
+                       &ControlLoopRunnerConfig::command_timeout)
+        .def_readwrite("safety_damping",
+                       &ControlLoopRunnerConfig::safety_damping)
+        .def_readwrite("control_thread_priority",
+                       &ControlLoopRunnerConfig::control_thread_priority);
+
+    // The phase labels must outlive the sequence: Python only gets the
+    // default ones.
+    py::class_<Solo12::Sequence>(m, "Solo12MotionSequence")
+        .def(py::init<double, double, double>(),
+             py::arg("kp") = 3.0,
+             py::arg("kd") = 0.05,
+             py::arg("control_period") = 0.001)
+        .def("add_move_to",
+             [](Solo12::Sequence& sequence,
+                const Solo12::JointVector& pose,
+                double duration) {
+                 return sequence.add_move_to(pose, duration);
+             },
+             py::arg("pose"),
+             py::arg("duration"))
+        .def("add_hold",
+             [](Solo12::Sequence& sequence, double duration) {
+                 return sequence.add_hold(duration);
+             },
+             py::arg("duration"))
+        .def("clear", &Solo12::Sequence::clear)
+        .def("set_gains",
+             &Solo12::Sequence::set_gains,
+             py::arg("kp"),
+             py::arg("kd"))
+        .def("is_running", &Solo12::Sequence::is_running)
+        .def("get_phase_index", &Solo12::Sequence::get_phase_index)
+        .def("get_phase_label", &Solo12::Sequence::get_phase_label)
+        .def("get_phase_count", &Solo12::Sequence::get_phase_count);
+
+    py::class_<Solo12, std::shared_ptr<Solo12> >(m, "Solo12")
         .def(py::init<>())
         .def("initialize",
-             &Solo12::initialize,
+             py::overload_cast<const std::string&, const std::string&>(
+                 &Solo12::initialize),
              py::arg("interface_name"),
-             py::arg("serial_port"))
-        .def("acquire_sensors", &Solo12::acquire_sensors)
+             py::arg("serial_port"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("set_pipelined_acquisition",
+             &Solo12::set_pipelined_acquisition,
+             py::arg("enabled"),
+             py::arg("parse_period") = 0.00025)
+        .def("acquire_sensors",
+             &Solo12::acquire_sensors,
+             py::call_guard<py::gil_scoped_release>())
         .def("send_target_joint_torque",
              &Solo12::send_target_joint_torque,
-             py::arg("target_joint_torque"))
+             py::arg("target_joint_torque"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("wait_until_ready",
+             &Solo12::wait_until_ready,
+             py::call_guard<py::gil_scoped_release>())
+        .def("request_calibration",
+             &Solo12::request_calibration,
+             py::arg("home_offset_rad"))
+        .def("enable_calibration_cache",
+             &Solo12::enable_calibration_cache,
+             py::arg("file_path") =
+                 Solo12::Cache::get_default_path(Solo12Traits::name))
+        .def("save_calibration_cache", &Solo12::save_calibration_cache)
+        .def("is_calibration_restored", &Solo12::is_calibration_restored)
+        .def("is_ready", &Solo12::is_ready)
+        .def("is_calibrating", &Solo12::is_calibrating)
+        .def("has_error", &Solo12::has_error)
+        .def("start_motion_sequence",
+             &Solo12::start_motion_sequence,
+             py::arg("sequence"),
+             py::keep_alive<1, 2>())
+        .def("stop_motion_sequence", &Solo12::stop_motion_sequence)
+        .def("is_motion_sequence_running",
+             &Solo12::is_motion_sequence_running)
         .def(
             "set_max_current", &Solo12::set_max_current, py::arg("max_current"))
-        .def("get_motor_board_errors", &Solo12::get_motor_board_errors)
-        .def("get_motor_board_enabled", &Solo12::get_motor_board_enabled)
-        .def("get_motor_enabled", &Solo12::get_motor_enabled)
-        .def("get_motor_ready", &Solo12::get_motor_ready)
-        .def("get_slider_positions", &Solo12::get_slider_positions)
-        .def("get_joint_positions", &Solo12::get_joint_positions)
-        .def("get_joint_velocities", &Solo12::get_joint_velocities);
+        .def("get_motor_board_errors",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_motor_board_errors(), self);
+             })
+        .def("get_motor_board_enabled",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_motor_board_enabled(), self);
+             })
+        .def("get_motor_enabled",
+             [](py::object self) {
+                 return read_only_view(self.cast<Solo12&>().get_motor_enabled(),
+                                       self);
+             })
+        .def("get_motor_ready",
+             [](py::object self) {
+                 return read_only_view(self.cast<Solo12&>().get_motor_ready(),
+                                       self);
+             })
+        .def("get_slider_positions",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_slider_positions(), self);
+             })
+        .def("get_slider_positions_age", &Solo12::get_slider_positions_age)
+        .def("is_slider_stale", &Solo12::is_slider_stale)
+        .def("set_slider_staleness_policy",
+             &Solo12::set_slider_staleness_policy,
+             py::arg("policy"))
+        .def("get_joint_positions",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_joint_positions(), self);
+             })
+        .def("get_joint_velocities",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_joint_velocities(), self);
+             })
+        .def("get_joint_torques",
+             [](py::object self) {
+                 return read_only_view(self.cast<Solo12&>().get_joint_torques(),
+                                       self);
+             })
+        .def("get_joint_target_torques",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_joint_target_torques(), self);
+             })
+        .def("get_joint_encoder_index",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_joint_encoder_index(), self);
+             })
+        .def("get_contact_sensors_states",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_contact_sensors_states(), self);
+             })
+        .def("get_imu_accelerometer",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_imu_accelerometer(), self);
+             })
+        .def("get_imu_gyroscope",
+             [](py::object self) {
+                 return read_only_view(self.cast<Solo12&>().get_imu_gyroscope(),
+                                       self);
+             })
+        .def("get_imu_attitude",
+             [](py::object self) {
+                 return read_only_view(self.cast<Solo12&>().get_imu_attitude(),
+                                       self);
+             })
+        .def("get_imu_linear_acceleration",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_imu_linear_acceleration(), self);
+             })
+        .def("get_imu_attitude_quaternion",
+             [](py::object self) {
+                 return read_only_view(
+                     self.cast<Solo12&>().get_imu_attitude_quaternion(), self);
+             })
+        .def("get_timing_statistics",
+             &Solo12::get_timing_statistics,
+             py::return_value_policy::reference_internal)
+        .def("reset_timing_statistics", &Solo12::reset_timing_statistics)
+        .def("set_timing_budget",
+             &Solo12::set_timing_budget,
+             py::arg("phase"),
+             py::arg("budget_sec"))
+        .def("read_sensor_frame", [](const Solo12& robot) {
+            Solo12SensorFrame frame;
+            robot.read_sensor_frame(frame);
+            return frame;
+        });
+
+    py::class_<Solo12ControlLoopRunner,
+               std::unique_ptr<Solo12ControlLoopRunner, GilReleasingDeleter> >(
+        m, "Solo12ControlLoopRunner")
+        .def(py::init<std::shared_ptr<Solo12>,
+                      const ControlLoopRunnerConfig&>(),
+             py::arg("robot"),
+             py::arg("config") = ControlLoopRunnerConfig())
+        .def(
+            "set_policy",
+            [](Solo12ControlLoopRunner& runner, py::function policy) {
+                std::shared_ptr<PythonPolicy> python_policy =
+                    std::make_shared<PythonPolicy>(policy);
+                runner.set_policy(
+                    [python_policy](const Solo12SensorFrame& frame,
+                                    Solo12JointCommand& command) {
+                        (*python_policy)(frame, command);
+                    });
+            },
+            py::arg("policy"))
+        .def("start", &Solo12ControlLoopRunner::start)
+        .def("stop",
+             &Solo12ControlLoopRunner::stop,
+             py::call_guard<py::gil_scoped_release>())
+        .def("is_running", &Solo12ControlLoopRunner::is_running)
+        .def("set_command",
+             &Solo12ControlLoopRunner::set_command,
+             py::arg("command"))
+        .def("read_frame",
+             [](const Solo12ControlLoopRunner& runner) {
+                 Solo12SensorFrame frame;
+                 runner.read_frame(frame);
+                 return frame;
+             })
+        .def("get_cycle_count", &Solo12ControlLoopRunner::get_cycle_count)
+        .def("get_control_overrun_count",
+             &Solo12ControlLoopRunner::get_control_overrun_count)
+        .def("get_stale_cycle_count",
+             &Solo12ControlLoopRunner::get_stale_cycle_count)
+        .def("is_damping", &Solo12ControlLoopRunner::is_damping)
+        .def("get_policy_call_count",
+             &Solo12ControlLoopRunner::get_policy_call_count)
+        .def("get_policy_overrun_count",
+             &Solo12ControlLoopRunner::get_policy_overrun_count);
 }